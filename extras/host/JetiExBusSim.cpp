@@ -0,0 +1,218 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExBusSim - simulation helpers for host tools: EX Bus receiver model
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     receiver ISR model (Attach/Update), corrupted channel packets
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "JetiExBusSim.h"
+
+JetiExBusSim::JetiExBusSim( JetiExDecoder * pDecoder, uint32_t periodUs, uint8_t nChannels, uint8_t jetiboxEvery )
+  : m_pDecoder( pDecoder ), m_periodUs( periodUs ), m_nChannels( nChannels ), m_jetiboxEvery( jetiboxEvery ), m_byteNs( 80000 ),
+    m_corruptEvery( 0 ), m_bRxIsr( false ), m_pHandler( 0 ), m_tiStartUs( 0 ), m_tiNextCycleUs( 0 ), m_packetId( 0 ), m_key( 0 ), m_bWaiting( false ), m_reqId( 0 ), m_reqPacketId( 0 ), m_tiReqEndNs( 0 )
+{
+  if( m_nChannels > JetiExBus::MAX_CHANNELS )
+    m_nChannels = JetiExBus::MAX_CHANNELS;
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+void JetiExBusSim::Init( uint32_t baud )
+{
+  m_byteNs        = (uint32_t)( 10 * 1000000000ULL / baud );   // start, 8 data, stop
+  m_tiStartUs     = micros();
+  m_tiNextCycleUs = m_tiStartUs;
+}
+
+bool JetiExBusSim::Attach( JetiExRxHandler * pHandler )
+{
+  m_pHandler = m_bRxIsr ? pHandler : 0;
+  return m_bRxIsr;
+}
+
+void JetiExBusSim::Update( JetiExVirtualClock & clock, uint64_t tiUs )
+{
+  Generate( tiUs );
+  while( m_pHandler && !m_rx.empty() && m_rx.front().tiNs <= tiUs * 1000 )
+  {
+    uint8_t c = m_rx.front().data;
+    clock.Set( m_rx.front().tiNs / 1000 );
+    m_rx.pop_front();
+    m_pHandler->OnReceive( c );
+  }
+  clock.Set( tiUs );
+}
+
+int JetiExBusSim::Read()
+{
+  uint64_t tiUs = micros();
+  Generate( tiUs );
+  if( m_rx.empty() || m_rx.front().tiNs > tiUs * 1000 )
+    return -1;
+
+  uint8_t c = m_rx.front().data;
+  m_rx.pop_front();
+  return c;
+}
+
+// receiver packets which have started until tiUs
+void JetiExBusSim::Generate( uint64_t tiUs )
+{
+  while( m_tiNextCycleUs <= tiUs )
+  {
+    // previous request has not been answered
+    if( m_bWaiting )
+    {
+      m_stats.nMissing++;
+      m_bWaiting = false;
+    }
+
+    uint64_t tiNs = m_tiNextCycleUs * 1000;
+    uint8_t  packet[ JetiExBusParser::MAX_PACKET ];
+    uint8_t  n;
+
+    // channels
+    packet[ 0 ] = JetiExBus::HDR_CHANNEL;
+    packet[ 1 ] = 0x03;
+    packet[ 2 ] = 8 + 2 * m_nChannels;
+    packet[ 3 ] = m_packetId++;
+    packet[ 4 ] = JetiExBus::ID_CHANNEL;
+    packet[ 5 ] = 2 * m_nChannels;
+    for( n = 0; n < m_nChannels; n++ )
+    {
+      uint16_t value = ChannelValue( m_stats.nCycles, n );
+      packet[ 6 + 2 * n ] = value & 0xFF;
+      packet[ 7 + 2 * n ] = value >> 8;
+    }
+    Queue( packet, packet[ 2 ], tiNs );
+    if( m_corruptEvery && ( m_stats.nCycles % m_corruptEvery ) == m_corruptEvery - 1 )
+    {
+      m_rx[ m_rx.size() - 5 ].data ^= 0x55;       // channel value
+      m_stats.nCorrupted++;
+    }
+
+    // telemetry or Jetibox request after a pause of 2 bytes
+    bool bJetibox = m_jetiboxEvery && ( m_stats.nCycles % m_jetiboxEvery ) == (uint32_t)m_jetiboxEvery - 1;
+    tiNs += 2 * m_byteNs;
+    packet[ 0 ] = JetiExBus::HDR_REQUEST;
+    packet[ 1 ] = 0x01;
+    packet[ 3 ] = m_packetId++;
+    if( bJetibox )
+    {
+      packet[ 4 ] = JetiExBus::ID_JETIBOX;
+      packet[ 5 ] = 1;
+      packet[ 6 ] = m_key ? m_key : 0xF0;
+      m_key       = 0;
+      packet[ 2 ] = 9;
+    }
+    else
+    {
+      packet[ 4 ] = JetiExBus::ID_TELEMETRY;
+      packet[ 5 ] = 0;
+      packet[ 2 ] = 8;
+    }
+    Queue( packet, packet[ 2 ], tiNs );
+
+    m_bWaiting    = true;
+    m_reqId       = packet[ 4 ];
+    m_reqPacketId = packet[ 3 ];
+    m_tiReqEndNs  = tiNs;
+    m_stats.nRequests++;
+    m_stats.nCycles++;
+    m_tiNextCycleUs += m_periodUs;
+  }
+}
+
+void JetiExBusSim::Queue( uint8_t * pPacket, uint8_t len, uint64_t & tiNs )
+{
+  uint16_t crc = JetiExBusParser::Crc16( pPacket, len - 2 );
+  pPacket[ len - 2 ] = crc & 0xFF;
+  pPacket[ len - 1 ] = crc >> 8;
+  for( uint8_t i = 0; i < len; i++ )
+  {
+    Byte b;
+    tiNs  += m_byteNs;
+    b.data = pPacket[ i ];
+    b.tiNs = tiNs;
+    m_rx.push_back( b );
+  }
+  m_stats.busyNs += (uint64_t)len * m_byteNs;
+}
+
+// answer from sensor
+void JetiExBusSim::Write( const uint8_t * pData, uint8_t n )
+{
+  uint64_t tiStartNs = (uint64_t)micros() * 1000;
+  uint64_t tiEndNs   = tiStartNs + (uint64_t)n * m_byteNs;
+  m_stats.busyNs    += (uint64_t)n * m_byteNs;
+
+  if( !m_bWaiting || tiStartNs < m_tiReqEndNs )
+  {
+    m_stats.nErrors++;
+    return;
+  }
+  m_bWaiting = false;
+  if( tiEndNs > m_tiNextCycleUs * 1000 )
+    m_stats.nCollisions++;
+
+  uint32_t latencyUs = (uint32_t)( ( tiStartNs - m_tiReqEndNs ) / 1000 );
+  if( latencyUs > JetiExBus::RESPONSE_US )
+  {
+    m_stats.nLate++;
+    return;
+  }
+
+  // check answer
+  JetiExBusParser parser;
+  bool            bValid = false;
+  for( uint8_t i = 0; i < n; i++ )
+    bValid = parser.Put( pData[ i ] );
+  if( !bValid || n != pData[ 2 ] || pData[ 0 ] != JetiExBus::HDR_ANSWER || pData[ 3 ] != m_reqPacketId || pData[ 4 ] != m_reqId )
+  {
+    m_stats.nErrors++;
+    return;
+  }
+  m_stats.nAnswers++;
+  m_latencies.push_back( latencyUs );
+
+  // EX protocol symbols to decoder
+  uint64_t        tiUs     = tiEndNs / 1000;
+  const uint8_t * pPayload = pData + 6;
+  if( pData[ 4 ] == JetiExBus::ID_TELEMETRY )
+  {
+    m_pDecoder->Put( 0x7E, tiUs );
+    for( uint8_t i = 0; i < pData[ 5 ]; i++ )
+      m_pDecoder->Put( 0x100 | pPayload[ i ], tiUs );
+  }
+  else
+  {
+    m_pDecoder->Put( 0xFE, tiUs );
+    for( uint8_t i = 0; i < pData[ 5 ]; i++ )
+      m_pDecoder->Put( 0x100 | pPayload[ i ], tiUs );
+    m_pDecoder->Put( 0xFF, tiUs );
+  }
+}
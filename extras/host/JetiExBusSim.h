@@ -0,0 +1,124 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExBusSim - simulation helpers for host tools: EX Bus receiver model
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     receiver ISR model (Attach/Update), corrupted channel packets
+
+  JetiExBusSim is an EX Bus port for JetiExBus which plays the part of the receiver:
+  every period it sends a channel packet followed by a telemetry request (a Jetibox
+  request every jetiboxEvery periods). Bytes arrive with the line timing of the selected
+  baud rate (10 bits per byte). Answers are checked (crc16, packet id, deadline, collision
+  with the next channel packet) and forwarded as EX symbols to a JetiExDecoder.
+  Time is taken from micros(), use it together with JetiExVirtualClock.
+  With SetRxIsr( true ) the port supports Attach(): Update() plays the receiver interrupt and
+  passes every byte at its arrival time to JetiExBus, otherwise JetiExBus polls with Read().
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXBUSSIM_H
+#define JETIEXBUSSIM_H
+
+#include <deque>
+#include <vector>
+#include "JetiExBus.h"
+#include "JetiExDecoder.h"
+
+// EX Bus receiver
+//////////////////
+class JetiExBusSim : public JetiExBusSerial
+{
+public:
+  typedef struct
+  {
+    uint32_t nCycles;      // channel packets
+    uint32_t nRequests;    // telemetry and Jetibox requests
+    uint32_t nAnswers;     // valid answers in time
+    uint32_t nLate;        // answer started after deadline, ignored
+    uint32_t nMissing;     // no answer until next packet
+    uint32_t nCollisions;  // answer not finished before next packet
+    uint32_t nErrors;      // bad crc, wrong packet id or unexpected answer
+    uint32_t nCorrupted;   // channel packets sent with bad crc
+    uint64_t busyNs;       // line busy time, both directions
+  }
+  Stats;
+
+  JetiExBusSim( JetiExDecoder * pDecoder, uint32_t periodUs = 10000, uint8_t nChannels = 16, uint8_t jetiboxEvery = 4 );
+
+  virtual void Init( uint32_t baud );
+  virtual int  Read();
+  virtual void Write( const uint8_t * pData, uint8_t n );
+  virtual bool Attach( JetiExRxHandler * pHandler );
+
+  void            SetRxIsr( bool bRxIsr ) { m_bRxIsr = bRxIsr; }
+  void            Update( JetiExVirtualClock & clock, uint64_t tiUs );   // receiver ISR: deliver bytes until tiUs, clock is set to the arrival times
+  void            SetCorruptEvery( uint32_t n ) { m_corruptEvery = n; }   // bad crc in every n-th channel packet, 0: none
+
+  void            PushKey( uint8_t key ) { m_key = key; }   // sent with next Jetibox request
+  uint16_t        ChannelValue( uint32_t cycle, uint8_t ch ) const { return 8000 + ( ( cycle * 8 + ch * 500 ) % 8000 ); }
+  uint32_t        CycleAt( uint64_t tiUs ) const { return (uint32_t)( ( tiUs - m_tiStartUs ) / m_periodUs ); }
+  uint64_t        ChannelEndUs( uint32_t cycle ) const { return m_tiStartUs + (uint64_t)cycle * m_periodUs + ( 8 + 2 * m_nChannels ) * m_byteNs / 1000; }
+  const Stats &   GetStats() const { return m_stats; }
+  std::vector<uint32_t> & GetLatencies() { return m_latencies; }  // request end until answer start, us
+
+protected:
+  void Generate( uint64_t tiUs );
+  void Queue( uint8_t * pPacket, uint8_t len, uint64_t & tiNs );
+
+  JetiExDecoder *  m_pDecoder;
+  uint32_t         m_periodUs;
+  uint8_t          m_nChannels;
+  uint8_t          m_jetiboxEvery;
+  uint32_t         m_byteNs;
+  uint32_t         m_corruptEvery;
+  bool             m_bRxIsr;
+  JetiExRxHandler * m_pHandler;
+
+  // bytes from receiver with arrival time (end of stop bit)
+  typedef struct
+  {
+    uint8_t  data;
+    uint64_t tiNs;
+  }
+  Byte;
+  std::deque<Byte> m_rx;
+
+  uint64_t         m_tiStartUs;
+  uint64_t         m_tiNextCycleUs;
+  uint8_t          m_packetId;
+  uint8_t          m_key;
+
+  // outstanding request
+  bool             m_bWaiting;
+  uint8_t          m_reqId;
+  uint8_t          m_reqPacketId;
+  uint64_t         m_tiReqEndNs;
+
+  Stats                 m_stats;
+  std::vector<uint32_t> m_latencies;
+};
+
+#endif // JETIEXBUSSIM_H
@@ -0,0 +1,307 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExCapture - binary capture file, record and replay serial ports (host side)
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     writer: pipes and devices get their own header
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <sys/stat.h>
+#include "JetiExCapture.h"
+
+static const char    _magic[ 7 ] = { 'J', 'E', 'T', 'I', 'C', 'A', 'P' };
+static const uint8_t _version    = 1;
+
+// JetiExCaptureWriter
+//////////////////////
+bool JetiExCaptureWriter::Open( const char * path )
+{
+  Close();
+
+  // pipe or device (i.e. FIFO of a gateway under test): not appended, every stream starts with a header
+  struct stat st;
+  bool bFile = stat( path, &st ) != 0 || S_ISREG( st.st_mode );
+
+  // existing file must be a capture
+  FILE * fp = bFile ? fopen( path, "rb" ) : 0;
+  if( fp )
+  {
+    uint8_t hdr[ 8 ];
+    size_t  n = fread( hdr, 1, sizeof( hdr ), fp );
+    fclose( fp );
+    if( n != 0 && ( n != sizeof( hdr ) || memcmp( hdr, _magic, sizeof( _magic ) ) != 0 || hdr[ 7 ] != _version ) )
+      return false;
+  }
+
+  m_fp = fopen( path, bFile ? "ab" : "wb" );
+  if( m_fp == 0 )
+    return false;
+
+  if( !bFile || ftell( m_fp ) == 0 )
+  {
+    fwrite( _magic, 1, sizeof( _magic ), m_fp );
+    fwrite( &_version, 1, 1, m_fp );
+  }
+  return true;
+}
+
+void JetiExCaptureWriter::Close()
+{
+  if( m_fp )
+    fclose( m_fp );
+  m_fp = 0;
+}
+
+void JetiExCaptureWriter::Mark( uint64_t tiUs )
+{
+  m_tiBase = tiUs;
+  m_tiLast = tiUs;
+  Write( REC_MARK, 0, tiUs );
+}
+
+void JetiExCaptureWriter::Write( uint8_t kind, uint8_t data, uint64_t tiUs )
+{
+  if( m_fp == 0 )
+    return;
+
+  uint64_t dt = tiUs > m_tiLast ? tiUs - m_tiLast : 0;
+  m_tiLast   += dt;
+
+  if( dt < 63 )
+    putc( kind | ( dt << 2 ), m_fp );
+  else
+  {
+    putc( kind | ( 63 << 2 ), m_fp );
+    do
+    {
+      uint8_t c = dt & 0x7F;
+      dt >>= 7;
+      putc( dt ? c | 0x80 : c, m_fp );
+    }
+    while( dt );
+  }
+  putc( data, m_fp );
+}
+
+// JetiExCaptureReader
+//////////////////////
+bool JetiExCaptureReader::IsCapture( const char * path )
+{
+  uint8_t hdr[ 8 ];
+  FILE *  fp = fopen( path, "rb" );
+  if( fp == 0 )
+    return false;
+  size_t n = fread( hdr, 1, sizeof( hdr ), fp );
+  fclose( fp );
+  return n == sizeof( hdr ) && memcmp( hdr, _magic, sizeof( _magic ) ) == 0;
+}
+
+bool JetiExCaptureReader::Open( const char * path )
+{
+  Close();
+  m_fp = fopen( path, "rb" );
+  if( m_fp == 0 )
+    return false;
+
+  uint8_t hdr[ 8 ];
+  if( fread( hdr, 1, sizeof( hdr ), m_fp ) != sizeof( hdr ) || memcmp( hdr, _magic, sizeof( _magic ) ) != 0 || hdr[ 7 ] != _version )
+  {
+    Close();
+    return false;
+  }
+
+  m_pos     = m_len = 0;
+  m_tiUs    = 0;
+  m_session = 0;
+  m_bFirst  = true;
+  return true;
+}
+
+void JetiExCaptureReader::Close()
+{
+  if( m_fp )
+    fclose( m_fp );
+  m_fp = 0;
+}
+
+bool JetiExCaptureReader::Next( JetiExCaptureRecord & rec )
+{
+  if( m_fp == 0 )
+    return false;
+
+  int tag = GetByte();
+  if( tag < 0 )
+    return false;
+
+  uint64_t dt = tag >> 2;
+  if( dt == 63 )
+  {
+    int      c;
+    int      shift = 0;
+    dt = 0;
+    do
+    {
+      if( ( c = GetByte() ) < 0 )
+        return false;
+      dt    |= (uint64_t)( c & 0x7F ) << shift;
+      shift += 7;
+    }
+    while( c & 0x80 );
+  }
+
+  int data = GetByte();
+  if( data < 0 )
+    return false;
+
+  rec.kind = tag & 0x03;
+  rec.data = data;
+  if( rec.kind == JetiExCaptureWriter::REC_MARK )
+  {
+    if( !m_bFirst )
+      m_session++;
+    m_tiUs = 0;
+  }
+  else
+    m_tiUs += dt;
+  m_bFirst = false;
+
+  rec.tiUs    = m_tiUs;
+  rec.session = m_session;
+  return true;
+}
+
+// JetiExCaptureSerial
+//////////////////////
+JetiExCaptureSerial::JetiExCaptureSerial( const char * path, JetiExSerial * pPort ) : m_pPort( pPort )
+{
+  m_writer.Open( path );
+}
+
+void JetiExCaptureSerial::Init()
+{
+  if( m_pPort )
+    m_pPort->Init();
+  m_writer.Mark( micros() );
+}
+
+void JetiExCaptureSerial::Send( uint8_t data, boolean bit8 )
+{
+  m_writer.Write( bit8 ? JetiExCaptureWriter::REC_TX9 : JetiExCaptureWriter::REC_TX, data, micros() );
+  if( m_pPort )
+    m_pPort->Send( data, bit8 );
+}
+
+uint8_t JetiExCaptureSerial::Getchar(void)
+{
+  uint8_t c = m_pPort ? m_pPort->Getchar() : 0;
+  if( c )
+    m_writer.Write( JetiExCaptureWriter::REC_KEY, c, micros() );
+  return c;
+}
+
+// JetiExReplaySerial
+/////////////////////
+JetiExReplaySerial::JetiExReplaySerial( const char * inPath, uint32_t session, const char * outPath )
+  : m_session( session ), m_tiBase( 0 ), m_bKeyPending( false )
+{
+  memset( &m_stats, 0, sizeof( m_stats ) );
+  m_stats.firstMismatch = -1;
+
+  m_txReader.Open( inPath );
+  m_keyReader.Open( inPath );
+  if( outPath )
+    m_writer.Open( outPath );
+}
+
+void JetiExReplaySerial::Init()
+{
+  m_tiBase = micros();
+  m_writer.Mark( m_tiBase );
+}
+
+// next TX or key record of the selected session
+bool JetiExReplaySerial::NextOfKind( JetiExCaptureReader & reader, JetiExCaptureRecord & rec, bool bKey )
+{
+  while( reader.Next( rec ) )
+  {
+    if( rec.session < m_session )
+      continue;
+    if( rec.session > m_session )
+      return false;
+    if( bKey ? rec.kind == JetiExCaptureWriter::REC_KEY : rec.kind <= JetiExCaptureWriter::REC_TX9 )
+      return true;
+  }
+  return false;
+}
+
+void JetiExReplaySerial::Send( uint8_t data, boolean bit8 )
+{
+  m_writer.Write( bit8 ? JetiExCaptureWriter::REC_TX9 : JetiExCaptureWriter::REC_TX, data, micros() );
+
+  JetiExCaptureRecord rec;
+  if( NextOfKind( m_txReader, rec, false ) )
+  {
+    m_stats.nCompared++;
+    if( rec.data != data || ( rec.kind == JetiExCaptureWriter::REC_TX9 ) != ( bit8 != 0 ) )
+    {
+      if( m_stats.nMismatch++ == 0 )
+      {
+        m_stats.firstMismatch   = m_stats.nSent;
+        m_stats.tiFirstMismatch = rec.tiUs;
+      }
+    }
+  }
+  else
+    m_stats.nMissing++;
+
+  m_stats.nSent++;
+}
+
+uint8_t JetiExReplaySerial::Getchar(void)
+{
+  if( !m_bKeyPending )
+    m_bKeyPending = NextOfKind( m_keyReader, m_nextKey, true );
+
+  // deliver key at original time
+  if( m_bKeyPending && micros() - m_tiBase >= m_nextKey.tiUs )
+  {
+    m_bKeyPending = false;
+    m_stats.nKeys++;
+    m_writer.Write( JetiExCaptureWriter::REC_KEY, m_nextKey.data, micros() );
+    return m_nextKey.data;
+  }
+  return 0;
+}
+
+uint32_t JetiExReplaySerial::GetRemaining()
+{
+  JetiExCaptureRecord rec;
+  uint32_t            n = 0;
+  while( NextOfKind( m_txReader, rec, false ) )
+    n++;
+  return n;
+}
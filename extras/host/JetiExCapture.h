@@ -0,0 +1,194 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExCapture - binary capture file, record and replay serial ports (host side)
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Capture file format (append only):
+    header:  "JETICAP" + version byte (1)
+    records: tag byte [varint] data byte
+             tag bit 0..1: record kind (REC_TX, REC_TX9, REC_KEY, REC_MARK)
+             tag bit 2..7: time since previous record in us (0..62),
+                           63: time follows as unsigned LEB128 varint
+    Every Init() of a capture port appends a REC_MARK record, which starts a new
+    session. Timestamps are relative to the start of their session.
+    A transmitted symbol takes 2 bytes in most cases.
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXCAPTURE_H
+#define JETIEXCAPTURE_H
+
+#include <stdio.h>
+#include "JetiExSerial.h"
+
+// capture record
+/////////////////
+typedef struct
+{
+  uint8_t  kind;     // JetiExCaptureWriter::enRecord
+  uint8_t  data;
+  uint64_t tiUs;     // time since start of session
+  uint32_t session;  // 0 = first session in file
+}
+JetiExCaptureRecord;
+
+// capture file writer
+//////////////////////
+class JetiExCaptureWriter
+{
+public:
+  enum enRecord
+  {
+    REC_TX   = 0,    // transmitted symbol, 9th bit = 0 (separator)
+    REC_TX9  = 1,    // transmitted symbol, 9th bit = 1
+    REC_KEY  = 2,    // received Jetibox key
+    REC_MARK = 3,    // start of session
+  };
+
+  JetiExCaptureWriter() : m_fp( 0 ), m_tiBase( 0 ), m_tiLast( 0 ) {}
+  ~JetiExCaptureWriter() { Close(); }
+
+  bool Open( const char * path );                         // append to file, header is written for new files
+  void Close();
+  bool IsOpen() const { return m_fp != 0; }
+
+  void Mark( uint64_t tiUs );                             // start new session, tiUs = absolute time of session start
+  void Write( uint8_t kind, uint8_t data, uint64_t tiUs ); // tiUs = absolute time
+  void Flush() { if( m_fp ) fflush( m_fp ); }
+
+protected:
+  FILE *   m_fp;
+  uint64_t m_tiBase;
+  uint64_t m_tiLast;
+};
+
+// capture file reader
+//////////////////////
+class JetiExCaptureReader
+{
+public:
+  JetiExCaptureReader() : m_fp( 0 ), m_pos( 0 ), m_len( 0 ), m_tiUs( 0 ), m_session( 0 ), m_bFirst( true ) {}
+  ~JetiExCaptureReader() { Close(); }
+
+  bool Open( const char * path );
+  void Close();
+  bool IsOpen() const { return m_fp != 0; }
+
+  bool Next( JetiExCaptureRecord & rec );                 // false at end of file
+
+  static bool IsCapture( const char * path );             // check header
+
+protected:
+  enum { BUFSIZE = 65536 };
+
+  inline int GetByte()
+  {
+    if( m_pos >= m_len )
+    {
+      m_len = fread( m_buf, 1, BUFSIZE, m_fp );
+      m_pos = 0;
+      if( m_len == 0 )
+        return -1;
+    }
+    return m_buf[ m_pos++ ];
+  }
+
+  FILE *   m_fp;
+  uint8_t  m_buf[ BUFSIZE ];
+  size_t   m_pos;
+  size_t   m_len;
+  uint64_t m_tiUs;
+  uint32_t m_session;
+  bool     m_bFirst;
+};
+
+// record all traffic of a serial port
+//////////////////////////////////////
+class JetiExCaptureSerial : public JetiExSerial
+{
+public:
+  JetiExCaptureSerial( const char * path, JetiExSerial * pPort = 0 ); // pPort = 0: output is discarded
+
+  virtual void    Init();
+  virtual void    Send( uint8_t data, boolean bit8 );
+  virtual uint8_t Getchar(void);
+  virtual void    TxOn()  { if( m_pPort ) m_pPort->TxOn(); }
+  virtual void    TxOff() { if( m_pPort ) m_pPort->TxOff(); }
+  virtual void    Poll()  { if( m_pPort ) m_pPort->Poll(); }
+  virtual uint16_t TxFree() { return m_pPort ? m_pPort->TxFree() : 0xFFFF; }
+
+  bool IsOpen() const { return m_writer.IsOpen(); }
+  void Flush() { m_writer.Flush(); }
+
+protected:
+  JetiExCaptureWriter m_writer;
+  JetiExSerial *      m_pPort;
+};
+
+// replay recorded keys with original timing and compare output
+///////////////////////////////////////////////////////////////
+class JetiExReplaySerial : public JetiExSerial
+{
+public:
+  typedef struct
+  {
+    uint32_t nSent;           // symbols sent
+    uint32_t nCompared;       // symbols compared with recording
+    uint32_t nMismatch;       // different symbols
+    uint32_t nMissing;        // sent more symbols than recorded
+    int64_t  firstMismatch;   // index of first different symbol, -1: none
+    uint64_t tiFirstMismatch; // session time of first different symbol (recording)
+    uint32_t nKeys;           // keys replayed
+  }
+  Stats;
+
+  JetiExReplaySerial( const char * inPath, uint32_t session = 0, const char * outPath = 0 );
+
+  virtual void    Init();
+  virtual void    Send( uint8_t data, boolean bit8 );
+  virtual uint8_t Getchar(void);
+  virtual void    TxOn() {}
+  virtual void    TxOff() {}
+
+  bool          IsOpen() const { return m_txReader.IsOpen() && m_keyReader.IsOpen(); }
+  const Stats & GetStats() const { return m_stats; }
+  uint32_t      GetRemaining();   // recorded symbols not sent in replay, call at end
+
+protected:
+  bool NextOfKind( JetiExCaptureReader & reader, JetiExCaptureRecord & rec, bool bKey );
+
+  JetiExCaptureReader m_txReader;
+  JetiExCaptureReader m_keyReader;
+  JetiExCaptureWriter m_writer;
+  uint32_t            m_session;
+  uint64_t            m_tiBase;
+  JetiExCaptureRecord m_nextKey;
+  bool                m_bKeyPending;
+  Stats               m_stats;
+};
+
+#endif // JETIEXCAPTURE_H
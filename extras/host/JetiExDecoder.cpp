@@ -0,0 +1,497 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExDecoder - streaming decoder for EX/Jetibox symbol streams (host side)
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "JetiExDecoder.h"
+#include <string.h>
+
+// Jeti data types, see JetiSensor::enDataType
+enum
+{
+  TYPE_6b   = 0,
+  TYPE_14b  = 1,
+  TYPE_22b  = 4,
+  TYPE_DT   = 5,
+  TYPE_30b  = 8,
+  TYPE_GPS  = 9,
+};
+
+// crc8 lookup table for polynomial X^8 + X^2 + X + 1 (POLY 0x07)
+const uint8_t JetiExDecoder::s_crcTable[ 256 ] =
+{
+  0x00, 0x07, 0x0E, 0x09, 0x1C, 0x1B, 0x12, 0x15, 0x38, 0x3F, 0x36, 0x31, 0x24, 0x23, 0x2A, 0x2D,
+  0x70, 0x77, 0x7E, 0x79, 0x6C, 0x6B, 0x62, 0x65, 0x48, 0x4F, 0x46, 0x41, 0x54, 0x53, 0x5A, 0x5D,
+  0xE0, 0xE7, 0xEE, 0xE9, 0xFC, 0xFB, 0xF2, 0xF5, 0xD8, 0xDF, 0xD6, 0xD1, 0xC4, 0xC3, 0xCA, 0xCD,
+  0x90, 0x97, 0x9E, 0x99, 0x8C, 0x8B, 0x82, 0x85, 0xA8, 0xAF, 0xA6, 0xA1, 0xB4, 0xB3, 0xBA, 0xBD,
+  0xC7, 0xC0, 0xC9, 0xCE, 0xDB, 0xDC, 0xD5, 0xD2, 0xFF, 0xF8, 0xF1, 0xF6, 0xE3, 0xE4, 0xED, 0xEA,
+  0xB7, 0xB0, 0xB9, 0xBE, 0xAB, 0xAC, 0xA5, 0xA2, 0x8F, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9D, 0x9A,
+  0x27, 0x20, 0x29, 0x2E, 0x3B, 0x3C, 0x35, 0x32, 0x1F, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0D, 0x0A,
+  0x57, 0x50, 0x59, 0x5E, 0x4B, 0x4C, 0x45, 0x42, 0x6F, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7D, 0x7A,
+  0x89, 0x8E, 0x87, 0x80, 0x95, 0x92, 0x9B, 0x9C, 0xB1, 0xB6, 0xBF, 0xB8, 0xAD, 0xAA, 0xA3, 0xA4,
+  0xF9, 0xFE, 0xF7, 0xF0, 0xE5, 0xE2, 0xEB, 0xEC, 0xC1, 0xC6, 0xCF, 0xC8, 0xDD, 0xDA, 0xD3, 0xD4,
+  0x69, 0x6E, 0x67, 0x60, 0x75, 0x72, 0x7B, 0x7C, 0x51, 0x56, 0x5F, 0x58, 0x4D, 0x4A, 0x43, 0x44,
+  0x19, 0x1E, 0x17, 0x10, 0x05, 0x02, 0x0B, 0x0C, 0x21, 0x26, 0x2F, 0x28, 0x3D, 0x3A, 0x33, 0x34,
+  0x4E, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5C, 0x5B, 0x76, 0x71, 0x78, 0x7F, 0x6A, 0x6D, 0x64, 0x63,
+  0x3E, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2C, 0x2B, 0x06, 0x01, 0x08, 0x0F, 0x1A, 0x1D, 0x14, 0x13,
+  0xAE, 0xA9, 0xA0, 0xA7, 0xB2, 0xB5, 0xBC, 0xBB, 0x96, 0x91, 0x98, 0x9F, 0x8A, 0x8D, 0x84, 0x83,
+  0xDE, 0xD9, 0xD0, 0xD7, 0xC2, 0xC5, 0xCC, 0xCB, 0xE6, 0xE1, 0xE8, 0xEF, 0xFA, 0xFD, 0xF4, 0xF3,
+};
+
+// JetiExDecoder
+////////////////
+JetiExDecoder::JetiExDecoder( JetiExDecoderSink * pSink ) : m_pSink( pSink ), m_nDevices( 0 )
+{
+  memset( m_devices, 0, sizeof( m_devices ) );
+  Reset();
+}
+
+JetiExDecoder::~JetiExDecoder()
+{
+  Reset();
+}
+
+void JetiExDecoder::Reset()
+{
+  for( int i = 0; i < m_nDevices; i++ )
+    for( int j = 0; j < 256; j++ )
+      delete m_devices[ i ].pEntries[ j ];
+  memset( m_devices, 0, sizeof( m_devices ) );
+  memset( &m_stats, 0, sizeof( m_stats ) );
+  m_nDevices = 0;
+  m_tiUs     = 0;
+  m_symbolUs = SYMBOL_US;
+  m_state    = ST_IDLE;
+  m_n        = 0;
+  m_frameLen = 0;
+}
+
+void JetiExDecoder::Decode( const uint16_t * pSymbols, size_t n )
+{
+  const uint16_t * pEnd = pSymbols + n;
+  while( pSymbols < pEnd )
+  {
+    m_tiUs += m_symbolUs;
+    PutSymbol( *pSymbols++ );
+  }
+}
+
+void JetiExDecoder::PutSymbol( uint16_t symbol )
+{
+  uint8_t c = symbol & 0xFF;
+  m_stats.nSymbols++;
+
+  // separators have 9th bit cleared
+  if( ( symbol & 0x100 ) == 0 )
+  {
+    OnSeparator( c );
+    return;
+  }
+
+  switch( m_state )
+  {
+  case ST_IDLE:
+    Error( ERR_GARBAGE );
+    break;
+
+  case ST_EXHDR:                                       // 0x?F = EX data, 0x?2 = alarm, 0x?1 = Jetibox message
+    m_buf[ 1 ] = c;
+    switch( c & 0x0F )
+    {
+    case 0x0F: m_state = ST_EXLEN; break;
+    case 0x02: m_state = ST_ALARM; m_n = 0; break;
+    case 0x01: m_state = ST_MSG;   break;
+    default:   m_state = ST_IDLE;  Error( ERR_SEPARATOR ); break;
+    }
+    break;
+
+  case ST_EXLEN:
+    m_buf[ 2 ]  = c;
+    m_frameLen  = ( c & 0x3F ) + 2;                    // index of crc byte
+    if( m_frameLen < 8 )
+    {
+      m_state = ST_IDLE;
+      Error( ERR_LENGTH );
+      break;
+    }
+    m_n     = 3;
+    m_state = ST_EXDATA;
+    break;
+
+  case ST_EXDATA:
+    m_buf[ m_n ] = c;
+    if( m_n++ == m_frameLen )
+    {
+      m_state = ST_IDLE;
+      DecodeExFrame();
+    }
+    break;
+
+  case ST_ALARM:                                        // 0x22/0x23 alarm type, followed by morse character
+    m_buf[ 2 + m_n++ ] = c;
+    if( m_n == 2 )
+    {
+      m_state = ST_IDLE;
+      m_stats.nAlarms++;
+      if( m_pSink )
+        m_pSink->OnAlarm( (char)m_buf[ 3 ], ( m_buf[ 2 ] & 0x01 ) != 0, m_tiUs );
+    }
+    break;
+
+  case ST_MSG:
+    m_state = ST_IDLE;
+    if( c == 0x31 )                                     // exit
+    {
+      m_stats.nExits++;
+      if( m_pSink )
+        m_pSink->OnExit( m_tiUs );
+    }
+    break;
+
+  case ST_TEXT:
+    m_buf[ m_n++ ] = c;
+    if( m_n == 32 )
+      m_state = ST_TEXTEND;
+    break;
+
+  case ST_TEXTEND:                                      // more than 32 characters
+    m_state = ST_IDLE;
+    Error( ERR_LENGTH );
+    break;
+  }
+}
+
+void JetiExDecoder::OnSeparator( uint8_t c )
+{
+  // text frame complete ?
+  if( c == 0xFF )
+  {
+    if( m_state == ST_TEXTEND )
+    {
+      m_stats.nTextFrames++;
+      if( m_pSink )
+        m_pSink->OnText( (const char*)m_buf, m_tiUs );
+    }
+    else if( m_state != ST_IDLE )
+      Error( ERR_TRUNCATED );
+    m_state = ST_IDLE;
+    return;
+  }
+
+  // every other separator starts a new frame (resync)
+  if( m_state != ST_IDLE )
+    Error( ERR_TRUNCATED );
+
+  switch( c )
+  {
+  case 0x7E: m_state = ST_EXHDR; m_buf[ 0 ] = c; break;
+  case 0xFE: m_state = ST_TEXT;  m_n = 0;        break;
+  default:   m_state = ST_IDLE;  Error( ERR_SEPARATOR ); break;
+  }
+}
+
+void JetiExDecoder::DecodeExFrame()
+{
+  if( Crc8( m_buf, 2, m_frameLen ) != m_buf[ m_frameLen ] )
+  {
+    m_stats.nCrcErrors++;
+    Error( ERR_CRC );
+    return;
+  }
+
+  uint16_t devId = m_buf[ 5 ] | ( m_buf[ 6 ] << 8 );
+  bool     bData = ( m_buf[ 2 ] & 0xC0 ) == 0x40;
+
+  m_stats.nExFrames++;
+  if( m_pSink )
+    m_pSink->OnExFrame( devId, bData, m_frameLen + 1, m_tiUs );
+
+  if( bData )
+    DecodeDataFrame( devId );
+  else
+    DecodeDictFrame( devId );
+}
+
+void JetiExDecoder::DecodeDictFrame( uint16_t devId )
+{
+  uint8_t textLen = m_buf[ 9 ] >> 3;
+  uint8_t unitLen = m_buf[ 9 ] & 0x07;
+  if( m_frameLen < 10 || 10 + textLen + unitLen > m_frameLen )
+  {
+    Error( ERR_LENGTH );
+    return;
+  }
+  m_stats.nDictFrames++;
+
+  int devIdx = FindDevice( devId, true );
+  if( devIdx < 0 )
+    return;
+
+  JetiExDictEntry *& pEntry = m_devices[ devIdx ].pEntries[ m_buf[ 8 ] ];
+  if( pEntry == 0 )
+    pEntry = new JetiExDictEntry;
+
+  pEntry->devId = devId;
+  pEntry->id    = m_buf[ 8 ];
+  memcpy( pEntry->text, m_buf + 10, textLen );
+  pEntry->text[ textLen ] = '\0';
+  memcpy( pEntry->unit, m_buf + 10 + textLen, unitLen );
+  pEntry->unit[ unitLen ] = '\0';
+
+  if( m_pSink )
+    m_pSink->OnDictionary( *pEntry, m_tiUs );
+}
+
+void JetiExDecoder::DecodeDataFrame( uint16_t devId )
+{
+  JetiExValue v;
+  uint8_t     n = 8;
+
+  m_stats.nDataFrames++;
+  v.devId = devId;
+
+  while( n < m_frameLen )
+  {
+    v.id       = m_buf[ n ] >> 4;
+    v.dataType = m_buf[ n++ ] & 0x0F;
+    if( v.id == 0 )                                     // sensor id > 15 in next byte
+      v.id = m_buf[ n++ ];
+
+    uint8_t len;
+    switch( v.dataType )
+    {
+    case TYPE_6b:  len = 1; break;
+    case TYPE_14b: len = 2; break;
+    case TYPE_22b: len = 3; break;
+    case TYPE_DT:  len = 3; break;
+    case TYPE_30b: len = 4; break;
+    case TYPE_GPS: len = 4; break;
+    default:       Error( ERR_DATATYPE ); return;
+    }
+    if( n + len > m_frameLen )
+    {
+      Error( ERR_LENGTH );
+      return;
+    }
+
+    const uint8_t * p  = m_buf + n;
+    uint8_t       last = p[ len - 1 ];
+    uint32_t      raw  = 0;
+    for( int i = len - 1; i >= 0; i-- )
+      raw = ( raw << 8 ) | p[ i ];
+    n += len;
+
+    v.precision  = 0;
+    v.bDate      = false;
+    v.bLongitude = false;
+    v.gps        = 0;
+    memset( v.dt, 0, sizeof( v.dt ) );
+
+    switch( v.dataType )
+    {
+    case TYPE_DT:                                       // see SetSensorValueDate()/SetSensorValueTime()
+      v.value  = (int32_t)raw;
+      v.bDate  = ( last & 0x20 ) != 0;
+      v.dt[ 0 ] = last & 0x1F;                          // day or hour
+      v.dt[ 1 ] = p[ 1 ];                               // month or minute
+      v.dt[ 2 ] = p[ 0 ];                               // year or second
+      break;
+
+    case TYPE_GPS:                                      // see SetSensorValueGPS()
+      v.value      = (int32_t)raw;
+      v.bLongitude = ( last & 0x20 ) != 0;
+      v.gps        = ( p[ 2 ] | ( ( last & 0x01 ) << 8 ) ) + ( p[ 0 ] | ( p[ 1 ] << 8 ) ) / 60000.0;
+      if( last & 0x40 )
+        v.gps = -v.gps;
+      break;
+
+    default:                                            // 5 bit hi byte, precision in bit 5/6, sign in bit 7
+      {
+        uint8_t  bits = len * 8 - 3;
+        uint32_t mask = ( 1UL << bits ) - 1;
+        v.precision = ( last >> 5 ) & 0x03;
+        v.value     = (int32_t)( raw & mask );
+        if( last & 0x80 )                               // JetiSensor::jetiEncodeValue() keeps two's complement below the sign bit
+          v.value -= (int32_t)( 1UL << bits );
+      }
+      break;
+    }
+
+    m_stats.nValues++;
+    if( m_pSink )
+      m_pSink->OnValue( v, m_tiUs );
+  }
+}
+
+void JetiExDecoder::Error( uint8_t err )
+{
+  m_stats.nErrors++;
+  if( m_pSink )
+    m_pSink->OnError( err, m_tiUs );
+}
+
+int JetiExDecoder::FindDevice( uint16_t devId, bool bCreate )
+{
+  for( int i = 0; i < m_nDevices; i++ )
+    if( m_devices[ i ].devId == devId )
+      return i;
+
+  if( !bCreate || m_nDevices >= MAX_DEVICES )
+    return -1;
+
+  m_devices[ m_nDevices ].devId = devId;
+  return m_nDevices++;
+}
+
+const JetiExDictEntry * JetiExDecoder::GetDictionary( uint16_t devId, uint8_t id ) const
+{
+  for( int i = 0; i < m_nDevices; i++ )
+    if( m_devices[ i ].devId == devId )
+      return m_devices[ i ].pEntries[ id ];
+  return 0;
+}
+
+uint8_t JetiExDecoder::Crc8( const uint8_t * buf, uint8_t from, uint8_t to )
+{
+  uint8_t crc = 0;
+  for( uint8_t c = from; c < to; c++ )
+    crc = s_crcTable[ crc ^ buf[ c ] ];
+  return crc;
+}
+
+double JetiExDecoder::ToDouble( const JetiExValue & value )
+{
+  switch( value.dataType )
+  {
+  case TYPE_GPS: return value.gps;
+  case TYPE_DT:  return value.value;
+  }
+
+  double v = value.value;
+  for( int i = 0; i < value.precision; i++ )
+    v /= 10;
+  return v;
+}
+
+const char * JetiExDecoder::TypeName( uint8_t dataType )
+{
+  switch( dataType )
+  {
+  case TYPE_6b:  return "6b";
+  case TYPE_14b: return "14b";
+  case TYPE_22b: return "22b";
+  case TYPE_DT:  return "DT";
+  case TYPE_30b: return "30b";
+  case TYPE_GPS: return "GPS";
+  }
+  return "?";
+}
+
+
+// JetiExRefreshStats
+/////////////////////
+JetiExRefreshStats::JetiExRefreshStats( JetiExDecoderSink * pNext ) : m_pNext( pNext ), m_nEntries( 0 ), m_nDevIds( 0 )
+{
+  memset( m_pEntries, 0, sizeof( m_pEntries ) );
+  memset( m_lookup, 0, sizeof( m_lookup ) );
+  memset( m_devIds, 0, sizeof( m_devIds ) );
+}
+
+JetiExRefreshStats::~JetiExRefreshStats()
+{
+  for( int i = 0; i < m_nEntries; i++ )
+    delete m_pEntries[ i ];
+}
+
+const JetiExRefreshStats::Entry * JetiExRefreshStats::Find( uint16_t devId, uint8_t id ) const
+{
+  for( int i = 0; i < m_nDevIds; i++ )
+    if( m_devIds[ i ] == devId && m_lookup[ i ][ id ] )
+      return m_pEntries[ m_lookup[ i ][ id ] - 1 ];
+  return 0;
+}
+
+void JetiExRefreshStats::OnValue( const JetiExValue & value, uint64_t tiUs )
+{
+  // device slot
+  int dev;
+  for( dev = 0; dev < m_nDevIds; dev++ )
+    if( m_devIds[ dev ] == value.devId )
+      break;
+  if( dev == m_nDevIds )
+  {
+    if( m_nDevIds >= 16 )
+      return;
+    m_devIds[ m_nDevIds++ ] = value.devId;
+  }
+
+  // sensor entry
+  int32_t & idx = m_lookup[ dev ][ value.id ];
+  if( idx == 0 )
+  {
+    if( m_nEntries >= MAX_ENTRIES )
+      return;
+    Entry * pEntry = new Entry;
+    memset( pEntry, 0, sizeof( Entry ) );
+    pEntry->devId       = value.devId;
+    pEntry->id          = value.id;
+    pEntry->tiFirst     = tiUs;
+    pEntry->minInterval = (uint64_t)-1;
+    m_pEntries[ m_nEntries++ ] = pEntry;
+    idx = m_nEntries;
+  }
+  else
+  {
+    Entry *  pEntry   = m_pEntries[ idx - 1 ];
+    uint64_t interval = tiUs - pEntry->tiLast;
+    if( interval < pEntry->minInterval )
+      pEntry->minInterval = interval;
+    if( interval > pEntry->maxInterval )
+      pEntry->maxInterval = interval;
+    if( value.value != pEntry->lastValue )
+      pEntry->nChanges++;
+  }
+
+  Entry * pEntry     = m_pEntries[ idx - 1 ];
+  pEntry->dataType   = value.dataType;
+  pEntry->lastValue  = value.value;
+  pEntry->tiLast     = tiUs;
+  pEntry->nValues++;
+
+  if( m_pNext )
+    m_pNext->OnValue( value, tiUs );
+}
+
+// forward all other events
+void JetiExRefreshStats::OnDictionary( const JetiExDictEntry & entry, uint64_t tiUs )            { if( m_pNext ) m_pNext->OnDictionary( entry, tiUs ); }
+void JetiExRefreshStats::OnExFrame( uint16_t devId, bool bData, uint8_t nBytes, uint64_t tiUs ) { if( m_pNext ) m_pNext->OnExFrame( devId, bData, nBytes, tiUs ); }
+void JetiExRefreshStats::OnAlarm( char code, bool bSound, uint64_t tiUs )                       { if( m_pNext ) m_pNext->OnAlarm( code, bSound, tiUs ); }
+void JetiExRefreshStats::OnExit( uint64_t tiUs )                                                { if( m_pNext ) m_pNext->OnExit( tiUs ); }
+void JetiExRefreshStats::OnText( const char * text, uint64_t tiUs )                             { if( m_pNext ) m_pNext->OnText( text, tiUs ); }
+void JetiExRefreshStats::OnError( uint8_t error, uint64_t tiUs )                                { if( m_pNext ) m_pNext->OnError( error, tiUs ); }
@@ -0,0 +1,254 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExDecoder - streaming decoder for EX/Jetibox symbol streams (host side)
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Decodes the 9 bit symbol stream produced by JetiExProtocol:
+  - 0x7E/0xFE/0xFF separators (9th bit = 0), data symbols (9th bit = 1)
+  - EX frames with crc8 check, sensor dictionary and typed values (incl. GPS, date/time)
+  - morse alarms, Jetibox exit and Jetibox text frames
+  The decoder resynchronizes on every separator, so it can be fed with captures
+  starting at an arbitrary position.
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXDECODER_H
+#define JETIEXDECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "JetiExSerial.h"
+
+// decoded dictionary entry (sensor label)
+//////////////////////////////////////////
+typedef struct
+{
+  uint16_t devId;          // device id (lo/hi of EX header), manufacturer id is not part of the key
+  uint8_t  id;             // sensor id, 0 = device name
+  char     text[ 32 ];     // description, '\0' terminated
+  char     unit[ 8 ];      // unit, '\0' terminated
+}
+JetiExDictEntry;
+
+// decoded sensor value
+///////////////////////
+typedef struct
+{
+  uint16_t devId;
+  uint8_t  id;
+  uint8_t  dataType;       // JetiSensor::enDataType
+  uint8_t  precision;      // 0..2 decimal places
+  int32_t  value;          // signed raw value, precision not applied
+
+  // special data types
+  bool     bDate;          // TYPE_DT: true = date, false = time
+  uint8_t  dt[ 3 ];        // TYPE_DT: day/month/year-2000 or hour/minute/second
+  bool     bLongitude;     // TYPE_GPS: true = longitude, false = latitude
+  double   gps;            // TYPE_GPS: degrees, negative for west/south
+}
+JetiExValue;
+
+// event receiver, override what you need
+/////////////////////////////////////////
+class JetiExDecoderSink
+{
+public:
+  virtual ~JetiExDecoderSink() {}
+
+  virtual void OnDictionary( const JetiExDictEntry & entry, uint64_t tiUs ) {}
+  virtual void OnValue( const JetiExValue & value, uint64_t tiUs ) {}
+  virtual void OnExFrame( uint16_t devId, bool bData, uint8_t nBytes, uint64_t tiUs ) {}
+  virtual void OnAlarm( char code, bool bSound, uint64_t tiUs ) {}
+  virtual void OnExit( uint64_t tiUs ) {}
+  virtual void OnText( const char * text, uint64_t tiUs ) {} // 32 characters, not terminated
+  virtual void OnError( uint8_t error, uint64_t tiUs ) {}
+};
+
+// decoder
+//////////
+class JetiExDecoder
+{
+public:
+  enum enError
+  {
+    ERR_CRC        = 1,  // EX frame with bad crc8
+    ERR_LENGTH     = 2,  // EX frame length out of range
+    ERR_TRUNCATED  = 3,  // frame interrupted by separator
+    ERR_GARBAGE    = 4,  // data symbol outside of a frame
+    ERR_DATATYPE   = 5,  // unknown data type in EX data frame
+    ERR_SEPARATOR  = 6,  // unknown separator
+  };
+
+  enum
+  {
+    SYMBOL_US      = JetiExSerial::SYMBOL_US, // default duration of one symbol: 12 bit at 9800 bps (start, 9 data, parity, stop)
+  };
+
+  // statistics
+  typedef struct
+  {
+    uint64_t nSymbols;
+    uint32_t nExFrames;
+    uint32_t nDataFrames;
+    uint32_t nDictFrames;
+    uint32_t nValues;
+    uint32_t nTextFrames;
+    uint32_t nAlarms;
+    uint32_t nExits;
+    uint32_t nCrcErrors;
+    uint32_t nErrors;     // all errors incl. crc
+  }
+  Stats;
+
+  JetiExDecoder( JetiExDecoderSink * pSink = 0 );
+  ~JetiExDecoder();
+
+  void SetSink( JetiExDecoderSink * pSink ) { m_pSink = pSink; }
+  void Reset();
+
+  // feed symbols: bit 0..7 data, bit 8 = 9th bit
+  // w/o timestamp, time is derived from the number of symbols (SYMBOL_US each)
+  inline void Put( uint16_t symbol ) { m_tiUs += m_symbolUs; PutSymbol( symbol ); }
+  inline void Put( uint16_t symbol, uint64_t tiUs ) { m_tiUs = tiUs; PutSymbol( symbol ); }
+  void        Decode( const uint16_t * pSymbols, size_t n );
+
+  void SetSymbolTime( uint32_t us ) { m_symbolUs = us; }
+
+  const Stats &           GetStats() const { return m_stats; }
+  const JetiExDictEntry * GetDictionary( uint16_t devId, uint8_t id ) const;
+
+  // value helpers
+  static double      ToDouble( const JetiExValue & value );
+  static const char * TypeName( uint8_t dataType );
+
+  // crc8 over buf[from..to-1], same polynomial as JetiExProtocol::jeti_crc8()
+  static uint8_t     Crc8( const uint8_t * buf, uint8_t from, uint8_t to );
+
+protected:
+  enum enState
+  {
+    ST_IDLE = 0,   // wait for separator
+    ST_EXHDR,      // byte after 0x7E: frame type
+    ST_EXLEN,      // EX frame type/length byte
+    ST_EXDATA,     // EX frame data incl. crc
+    ST_ALARM,      // alarm type and code
+    ST_MSG,        // Jetibox message (exit)
+    ST_TEXT,       // 32 text characters
+    ST_TEXTEND,    // wait for 0xFF
+  };
+
+  enum
+  {
+    MAX_DEVICES  = 16,
+    MAX_FRAMELEN = 64, // 6 bit length field + header
+  };
+
+  void PutSymbol( uint16_t symbol );
+  void OnSeparator( uint8_t c );
+  void DecodeExFrame();
+  void DecodeDataFrame( uint16_t devId );
+  void DecodeDictFrame( uint16_t devId );
+  void Error( uint8_t err );
+
+  int  FindDevice( uint16_t devId, bool bCreate );
+
+  JetiExDecoderSink * m_pSink;
+  Stats               m_stats;
+
+  // symbol timing
+  uint64_t            m_tiUs;
+  uint32_t            m_symbolUs;
+
+  // frame assembly
+  uint8_t             m_state;
+  uint8_t             m_n;
+  uint8_t             m_frameLen;  // index of crc byte
+  uint8_t             m_buf[ MAX_FRAMELEN + 4 ];
+
+  // dictionaries
+  typedef struct
+  {
+    uint16_t          devId;
+    JetiExDictEntry * pEntries[ 256 ];
+  }
+  Device;
+  Device              m_devices[ MAX_DEVICES ];
+  int                 m_nDevices;
+
+  static const uint8_t s_crcTable[ 256 ];
+};
+
+// per sensor refresh statistics
+////////////////////////////////
+class JetiExRefreshStats : public JetiExDecoderSink
+{
+public:
+  typedef struct
+  {
+    uint16_t devId;
+    uint8_t  id;
+    uint8_t  dataType;
+    uint32_t nValues;
+    uint32_t nChanges;  // value differs from last one
+    uint64_t tiFirst;
+    uint64_t tiLast;
+    uint64_t minInterval;
+    uint64_t maxInterval;
+    int32_t  lastValue;
+  }
+  Entry;
+
+  JetiExRefreshStats( JetiExDecoderSink * pNext = 0 );
+  ~JetiExRefreshStats();
+
+  virtual void OnDictionary( const JetiExDictEntry & entry, uint64_t tiUs );
+  virtual void OnValue( const JetiExValue & value, uint64_t tiUs );
+  virtual void OnExFrame( uint16_t devId, bool bData, uint8_t nBytes, uint64_t tiUs );
+  virtual void OnAlarm( char code, bool bSound, uint64_t tiUs );
+  virtual void OnExit( uint64_t tiUs );
+  virtual void OnText( const char * text, uint64_t tiUs );
+  virtual void OnError( uint8_t error, uint64_t tiUs );
+
+  int           GetCount() const { return m_nEntries; }
+  const Entry & Get( int idx ) const { return *m_pEntries[ idx ]; }
+  const Entry * Find( uint16_t devId, uint8_t id ) const;
+
+  // average interval in us, 0 if there are less than 2 values
+  static uint64_t AvgInterval( const Entry & e ) { return e.nValues > 1 ? ( e.tiLast - e.tiFirst ) / ( e.nValues - 1 ) : 0; }
+
+protected:
+  enum { MAX_ENTRIES = 16 * 256 };
+
+  JetiExDecoderSink * m_pNext;  // forward events (i.e. to printer)
+  Entry *             m_pEntries[ MAX_ENTRIES ];
+  int                 m_nEntries;
+  int32_t             m_lookup[ 16 ][ 256 ]; // device slot/id to entry index + 1
+  uint16_t            m_devIds[ 16 ];
+  int                 m_nDevIds;
+};
+
+#endif // JETIEXDECODER_H
@@ -0,0 +1,187 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExLogFile - value log (JetiExLog) on the host: file sink and decoder
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <string.h>
+#include "JetiExLogFile.h"
+
+bool JetiExLogReader::Open( const char * path )
+{
+  Close();
+  m_fp = fopen( path, "rb" );
+  if( m_fp == 0 )
+    return false;
+
+  // magic, version, millis() at start, devices
+  uint8_t hdr[ 13 ];
+  if( fread( hdr, 1, sizeof( hdr ), m_fp ) != sizeof( hdr ) || memcmp( hdr, "JETILOG", 7 ) != 0 || hdr[ 7 ] != JetiExLog::VERSION )
+  {
+    Close();
+    return false;
+  }
+  m_tiStart = hdr[ 8 ] | ( hdr[ 9 ] << 8 ) | ( hdr[ 10 ] << 16 ) | ( (uint32_t)hdr[ 11 ] << 24 );
+
+  // devices and sensors in slot order
+  uint8_t nDevices = hdr[ 12 ];
+  for( uint8_t dev = 0; dev < nDevices; dev++ )
+  {
+    uint8_t dh[ 3 ], name[ 32 ], nSensors;
+    if( fread( dh, 1, 3, m_fp ) != 3 || dh[ 2 ] >= sizeof( name ) || fread( name, 1, dh[ 2 ], m_fp ) != dh[ 2 ] || fread( &nSensors, 1, 1, m_fp ) != 1 )
+    {
+      Close();
+      return false;
+    }
+    for( uint8_t idx = 0; idx < nSensors; idx++ )
+    {
+      JetiExLogSensor s;
+      uint8_t         sh[ 4 ], unitLen;
+      memset( &s, 0, sizeof( s ) );
+      if( fread( sh, 1, 4, m_fp ) != 4 || sh[ 3 ] >= sizeof( s.text ) || fread( s.text, 1, sh[ 3 ], m_fp ) != sh[ 3 ] ||
+          fread( &unitLen, 1, 1, m_fp ) != 1 || unitLen >= sizeof( s.unit ) || fread( s.unit, 1, unitLen, m_fp ) != unitLen )
+      {
+        Close();
+        return false;
+      }
+      s.devId     = dh[ 0 ] | ( dh[ 1 ] << 8 );
+      s.dev       = dev;
+      s.id        = sh[ 0 ];
+      s.dataType  = sh[ 1 ];
+      s.precision = sh[ 2 ];
+      m_sensors.push_back( s );
+    }
+  }
+  m_prev.assign( m_sensors.size(), 0 );
+  return true;
+}
+
+void JetiExLogReader::Close()
+{
+  if( m_fp )
+    fclose( m_fp );
+  m_fp = 0;
+  m_sensors.clear();
+  m_prev.clear();
+  m_tiMs = 0;
+  m_nGap = 0;
+}
+
+bool JetiExLogReader::Next( JetiExLogRecord & rec )
+{
+  if( m_fp == 0 )
+    return false;
+
+  int tag;
+  while( ( tag = fgetc( m_fp ) ) != EOF )
+  {
+    uint32_t v = tag >> 2;
+    switch( tag & 0x03 )
+    {
+    case JetiExLog::REC_TIME:
+      if( v == 63 && !ReadVarint( v ) )
+        break;
+      m_tiMs += v;
+      continue;
+
+    case JetiExLog::REC_GAP:
+      if( !ReadVarint( v ) )
+        break;
+      m_nGap += v;
+      m_prev.assign( m_prev.size(), 0 );
+      continue;
+
+    case JetiExLog::REC_VALUE:
+      {
+        uint32_t zz;
+        if( ( v == 63 && !ReadVarint( v ) ) || v >= m_prev.size() || !ReadVarint( zz ) )
+          break;
+        uint32_t d = ( zz >> 1 ) ^ ( 0 - ( zz & 1 ) );
+        m_prev[ v ] = (int32_t)( (uint32_t)m_prev[ v ] + d );
+        rec.tiMs  = m_tiMs;
+        rec.slot  = v;
+        rec.value = m_prev[ v ];
+        rec.nGap  = m_nGap;
+        m_nGap    = 0;
+        return true;
+      }
+    }
+    m_nErrors++;
+    return false;
+  }
+  return false;
+}
+
+bool JetiExLogReader::ReadVarint( uint32_t & v )
+{
+  v = 0;
+  for( int shift = 0; shift < 35; shift += 7 )
+  {
+    int c = fgetc( m_fp );
+    if( c == EOF )
+      return false;
+    v |= (uint32_t)( c & 0x7F ) << shift;
+    if( !( c & 0x80 ) )
+      return true;
+  }
+  return false;
+}
+
+JetiExValue JetiExLogReader::ToValue( const JetiExLogRecord & rec ) const
+{
+  const JetiExLogSensor & s = m_sensors[ rec.slot ];
+  JetiExValue v;
+  memset( &v, 0, sizeof( v ) );
+  v.devId     = s.devId;
+  v.id        = s.id;
+  v.dataType  = s.dataType;
+  v.value     = rec.value;
+
+  uint32_t raw = (uint32_t)rec.value;
+  switch( s.dataType )
+  {
+  case JetiSensor::TYPE_DT:                           // see SetSensorValueDate()/SetSensorValueTime()
+    v.bDate   = ( raw & 0x200000 ) != 0;
+    v.dt[ 0 ] = ( raw >> 16 ) & 0x1F;
+    v.dt[ 1 ] = ( raw >> 8 ) & 0xFF;
+    v.dt[ 2 ] = raw & 0xFF;
+    break;
+
+  case JetiSensor::TYPE_GPS:                          // see SetSensorValueGPS()
+    v.bLongitude = ( raw & 0x20000000 ) != 0;
+    v.gps        = ( ( raw >> 16 ) & 0x1FF ) + ( raw & 0xFFFF ) / 60000.0;
+    if( raw & 0x40000000 )
+      v.gps = -v.gps;
+    break;
+
+  default:
+    v.precision = s.precision;
+    break;
+  }
+  return v;
+}
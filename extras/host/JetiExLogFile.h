@@ -0,0 +1,111 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExLogFile - value log (JetiExLog) on the host: file sink and decoder
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Format: see src/JetiExLog.h. The reader returns the sensor table of the header
+  and the values with absolute time (ms since start of log).
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXLOGFILE_H
+#define JETIEXLOGFILE_H
+
+#include <stdio.h>
+#include <vector>
+#include "JetiExLog.h"
+#include "JetiExDecoder.h"
+
+// log to file
+//////////////
+class JetiExFileLogSink : public JetiExLogSink
+{
+public:
+  JetiExFileLogSink( FILE * fp ) : m_fp( fp ) {}
+  virtual uint16_t Write( const uint8_t * pData, uint16_t n ) { return (uint16_t)fwrite( pData, 1, n, m_fp ); }
+protected:
+  FILE * m_fp;
+};
+
+// sensor of the log header
+///////////////////////////
+typedef struct
+{
+  uint16_t devId;
+  uint8_t  dev;            // device number
+  uint8_t  id;
+  uint8_t  dataType;       // JetiSensor::enDataType
+  uint8_t  precision;
+  char     text[ 32 ];
+  char     unit[ 8 ];
+}
+JetiExLogSensor;
+
+// log record
+/////////////
+typedef struct
+{
+  uint64_t tiMs;           // since start of log
+  uint16_t slot;           // index in GetSensors()
+  int32_t  value;          // as passed to SetSensorValue()
+  uint32_t nGap;           // records lost before this one
+}
+JetiExLogRecord;
+
+// log file reader
+//////////////////
+class JetiExLogReader
+{
+public:
+  JetiExLogReader() : m_fp( 0 ), m_tiStart( 0 ), m_tiMs( 0 ), m_nGap( 0 ), m_nErrors( 0 ) {}
+  ~JetiExLogReader() { Close(); }
+
+  bool Open( const char * path );                          // reads header
+  void Close();
+
+  bool Next( JetiExLogRecord & rec );                      // false at end of file or format error
+
+  const std::vector<JetiExLogSensor> & GetSensors() const { return m_sensors; }
+  uint32_t GetStartMillis() const { return m_tiStart; }    // millis() at start of log
+  uint32_t GetErrors() const { return m_nErrors; }         // format errors, reading stops
+
+  // value with data type and precision of the slot, like the EX decoder delivers it
+  JetiExValue ToValue( const JetiExLogRecord & rec ) const;
+
+protected:
+  bool ReadVarint( uint32_t & v );
+
+  FILE *                       m_fp;
+  std::vector<JetiExLogSensor> m_sensors;
+  std::vector<int32_t>         m_prev;
+  uint32_t                     m_tiStart;
+  uint64_t                     m_tiMs;
+  uint32_t                     m_nGap;
+  uint32_t                     m_nErrors;
+};
+
+#endif // JETIEXLOGFILE_H
@@ -0,0 +1,113 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExSim - simulation helpers for host tools: UART model
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <string.h>
+#include "JetiExSim.h"
+
+// JetiExUartModel
+//////////////////
+JetiExUartModel::JetiExUartModel( JetiExUartSink * pSink, uint32_t baud, uint8_t bitsPerSymbol, uint16_t ringSize )
+  : m_pSink( pSink ), m_ringSize( ringSize ), m_head( 0 ), m_n( 0 ), m_tiLineFreeNs( 0 ), m_nKeys( 0 )
+{
+  m_symbolNs  = (uint32_t)( ( 1000000000ULL * bitsPerSymbol + baud / 2 ) / baud );
+  m_queueSize = ringSize + 1;                     // ring buffer + symbol on the line
+  m_pQueue    = new Entry[ m_queueSize ];
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+JetiExUartModel::~JetiExUartModel()
+{
+  delete [] m_pQueue;
+}
+
+void JetiExUartModel::Send( uint8_t data, boolean bit8 )
+{
+  uint64_t tiNowUs = micros();
+  uint64_t tiNowNs = tiNowUs * 1000;
+  Update( tiNowUs );
+
+  // ring buffer full: symbol is lost like in JetiExHardwareSerialInt::Send()
+  uint16_t fill = GetFill( tiNowUs );
+  if( fill >= m_ringSize || m_n >= m_queueSize )
+  {
+    m_stats.nOverflow++;
+    return;
+  }
+
+  Entry & e    = m_pQueue[ ( m_head + m_n++ ) % m_queueSize ];
+  e.symbol     = data | ( bit8 ? 0x100 : 0 );
+  e.tiStartNs  = tiNowNs > m_tiLineFreeNs ? tiNowNs : m_tiLineFreeNs;
+  e.tiEndNs    = e.tiStartNs + m_symbolNs;
+  m_tiLineFreeNs = e.tiEndNs;
+
+  m_stats.nSymbols++;
+  m_stats.busyNs += m_symbolNs;
+  if( fill + 1 > m_stats.highWater )
+    m_stats.highWater = fill + 1;
+}
+
+void JetiExUartModel::Update( uint64_t tiUs )
+{
+  uint64_t tiNs = tiUs * 1000;
+  while( m_n > 0 && m_pQueue[ m_head ].tiEndNs <= tiNs )
+  {
+    const Entry & e = m_pQueue[ m_head ];
+    if( m_pSink )
+      m_pSink->OnSymbol( e.symbol, ( e.tiEndNs + 999 ) / 1000 );
+    m_head = ( m_head + 1 ) % m_queueSize;
+    m_n--;
+  }
+}
+
+// symbols waiting in ring buffer, the symbol on the line is not counted
+uint16_t JetiExUartModel::GetFill( uint64_t tiUs ) const
+{
+  uint64_t tiNs = tiUs * 1000;
+  uint16_t n    = 0;
+  for( uint16_t i = m_n; i > 0 && m_pQueue[ ( m_head + i - 1 ) % m_queueSize ].tiStartNs > tiNs; i-- )
+    n++;
+  return n;
+}
+
+void JetiExUartModel::PushKey( uint8_t key )
+{
+  if( m_nKeys < sizeof( m_keys ) )
+    m_keys[ m_nKeys++ ] = key;
+}
+
+uint8_t JetiExUartModel::Getchar(void)
+{
+  if( m_nKeys == 0 )
+    return 0;
+  uint8_t c = m_keys[ 0 ];
+  memmove( m_keys, m_keys + 1, --m_nKeys );
+  return c;
+}
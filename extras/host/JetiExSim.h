@@ -0,0 +1,114 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExSim - simulation helpers for host tools: UART model
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     TxHighWater(), TxOverflows()
+                     12 bits per symbol (9O1)
+
+  JetiExUartModel is a serial port for JetiExProtocol which models the transmit
+  ring buffer and the UART line timing without simulating CPU cycles:
+  each symbol starts when the line is free and takes bitsPerSymbol/baud seconds.
+  Symbols are delivered to a JetiExUartSink with the time their last bit has left
+  the UART. Time is taken from micros(), use it together with JetiExVirtualClock.
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXSIM_H
+#define JETIEXSIM_H
+
+#include "JetiExSerial.h"
+
+// receiver side of the UART model
+//////////////////////////////////
+class JetiExUartSink
+{
+public:
+  virtual ~JetiExUartSink() {}
+  virtual void OnSymbol( uint16_t symbol, uint64_t tiEndUs ) = 0; // symbol: bit 8 = 9th bit
+};
+
+// UART model
+/////////////
+class JetiExUartModel : public JetiExSerial
+{
+public:
+  typedef struct
+  {
+    uint32_t nSymbols;     // symbols accepted
+    uint32_t nOverflow;    // symbols dropped, ring buffer full
+    uint16_t highWater;    // max. ring buffer fill level
+    uint64_t busyNs;       // line busy time
+  }
+  Stats;
+
+  // defaults: 9800 bps, 9O1 (start + 9 data + parity + stop), 70 word ring buffer like JetiExHardwareSerialInt
+  JetiExUartModel( JetiExUartSink * pSink, uint32_t baud = 9800, uint8_t bitsPerSymbol = 12, uint16_t ringSize = 70 );
+  ~JetiExUartModel();
+
+  virtual void    Init() {}
+  virtual void    Send( uint8_t data, boolean bit8 );
+  virtual uint8_t Getchar(void);
+  virtual void    TxOn() {}
+  virtual void    TxOff() {}
+  virtual uint16_t TxFree() { return m_ringSize - GetFill( micros() ); }
+  virtual uint16_t TxHighWater() { return m_stats.highWater; }
+  virtual uint16_t TxOverflows() { return (uint16_t)m_stats.nOverflow; }
+
+  void          Update( uint64_t tiUs );          // deliver all symbols which have left the UART until tiUs
+  void          PushKey( uint8_t key );           // simulated Jetibox key from receiver
+  uint32_t      GetSymbolNs() const { return m_symbolNs; }
+  uint16_t      GetFill( uint64_t tiUs ) const;   // ring buffer fill level at tiUs
+  const Stats & GetStats() const { return m_stats; }
+
+protected:
+  typedef struct
+  {
+    uint16_t symbol;
+    uint64_t tiStartNs;
+    uint64_t tiEndNs;
+  }
+  Entry;
+
+  JetiExUartSink * m_pSink;
+  uint32_t         m_symbolNs;
+  uint16_t         m_ringSize;
+
+  // symbols in ring buffer or on the line, ordered by time
+  Entry *          m_pQueue;
+  uint16_t         m_queueSize;
+  uint16_t         m_head;
+  uint16_t         m_n;
+  uint64_t         m_tiLineFreeNs;
+
+  // receiver keys
+  uint8_t          m_keys[ 4 ];
+  uint8_t          m_nKeys;
+
+  Stats            m_stats;
+};
+
+#endif // JETIEXSIM_H
@@ -0,0 +1,256 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExTermios - serial port on Linux (POSIX termios), i.e. USB-UART on a companion computer
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "JetiExTermios.h"
+
+#ifndef CMSPAR
+  #error CMSPAR (mark/space parity) is not supported on this platform
+#endif
+
+// JetiExTermiosSerial
+//////////////////////
+JetiExTermiosSerial::JetiExTermiosSerial( const char * pDevice, bool bEcho )
+  : m_pDevice( pDevice ), m_fd( -1 ), m_bEcho( bEcho ), m_nEcho( 0 ), m_nRun( 0 ), m_bRunMark( false ), m_bLineMark( false )
+{
+  memset( &m_tio, 0, sizeof( m_tio ) );
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+JetiExTermiosSerial::~JetiExTermiosSerial()
+{
+  if( m_fd >= 0 )
+  {
+    Flush();
+    close( m_fd );
+  }
+}
+
+void JetiExTermiosSerial::Init()
+{
+  if( m_fd >= 0 || m_pDevice == 0 )
+    return;
+
+  m_fd = open( m_pDevice, O_RDWR | O_NOCTTY | O_NONBLOCK );
+  if( m_fd < 0 )
+  {
+    perror( m_pDevice );
+    return;
+  }
+
+  // 9600 bps, 8 data bits, space parity, 2 stop bits, raw, reads don't block
+  tcgetattr( m_fd, &m_tio );
+  cfmakeraw( &m_tio );
+  cfsetispeed( &m_tio, B9600 );
+  cfsetospeed( &m_tio, B9600 );
+  m_tio.c_cflag &= ~( CSIZE | PARODD | CRTSCTS );
+  m_tio.c_cflag |= CS8 | PARENB | CMSPAR | CSTOPB | CLOCAL | CREAD;
+  m_tio.c_iflag &= ~( INPCK | IXON | IXOFF );
+  m_tio.c_cc[ VMIN ]  = 0;
+  m_tio.c_cc[ VTIME ] = 0;
+  if( tcsetattr( m_fd, TCSANOW, &m_tio ) != 0 )
+    perror( m_pDevice );
+  tcflush( m_fd, TCIOFLUSH );
+  m_bLineMark = false;
+}
+
+void JetiExTermiosSerial::Send( uint8_t data, boolean bit8 )
+{
+  if( m_nRun && ( (bool)bit8 != m_bRunMark || m_nRun >= sizeof( m_run ) ) )
+    Flush();
+  m_bRunMark        = bit8;
+  m_run[ m_nRun++ ] = data;
+}
+
+void JetiExTermiosSerial::Flush()
+{
+  if( m_nRun == 0 )
+    return;
+
+  if( m_fd >= 0 && ( m_bRunMark == m_bLineMark || SetParity( m_bRunMark ) ) && Write( m_run, m_nRun ) )
+    m_stats.nSymbols += m_nRun;
+  else
+    m_stats.nErrors += m_nRun;
+  m_nRun = 0;
+}
+
+// new parity is valid when all previous symbols have been sent
+bool JetiExTermiosSerial::SetParity( bool bMark )
+{
+  if( bMark )
+    m_tio.c_cflag |= PARODD;   // with CMSPAR: mark
+  else
+    m_tio.c_cflag &= ~PARODD;  // space
+  if( tcsetattr( m_fd, TCSADRAIN, &m_tio ) != 0 )
+    return false;
+
+  m_bLineMark = bMark;
+  m_stats.nSwitches++;
+  return true;
+}
+
+bool JetiExTermiosSerial::Write( const uint8_t * pData, size_t n )
+{
+  m_stats.nWrites++;
+  while( n > 0 )
+  {
+    ssize_t r = write( m_fd, pData, n );
+    if( r < 0 )
+    {
+      if( errno != EAGAIN && errno != EINTR )
+        return false;
+      struct pollfd pfd = { m_fd, POLLOUT, 0 };
+      if( errno == EAGAIN && poll( &pfd, 1, 100 ) <= 0 )
+        return false;
+      continue;
+    }
+    if( m_bEcho )
+      m_nEcho += r;
+    pData += r;
+    n     -= r;
+  }
+  return true;
+}
+
+uint8_t JetiExTermiosSerial::Getchar(void)
+{
+  uint8_t c;
+  while( m_fd >= 0 && read( m_fd, &c, 1 ) == 1 )
+  {
+    if( m_nEcho )                               // own symbol
+    {
+      m_nEcho--;
+      continue;
+    }
+    if( c != 0xf0 && (c & 0x0f) == 0 )          // jetibox key
+      return c;
+  }
+  return 0;
+}
+
+// JetiExTermiosReader
+//////////////////////
+JetiExTermiosReader::JetiExTermiosReader() : m_fd( -1 ), m_bOwnFd( false ), m_state( 0 )
+{
+}
+
+JetiExTermiosReader::~JetiExTermiosReader()
+{
+  if( m_bOwnFd && m_fd >= 0 )
+    close( m_fd );
+}
+
+bool JetiExTermiosReader::Open( const char * pDevice )
+{
+  int fd = open( pDevice, O_RDWR | O_NOCTTY | O_NONBLOCK );
+  if( fd < 0 )
+    return false;
+
+  // space parity: symbols with 9th bit are parity errors and are marked
+  struct termios tio;
+  tcgetattr( fd, &tio );
+  cfmakeraw( &tio );
+  cfsetispeed( &tio, B9600 );
+  cfsetospeed( &tio, B9600 );
+  tio.c_cflag &= ~( CSIZE | PARODD | CRTSCTS );
+  tio.c_cflag |= CS8 | PARENB | CMSPAR | CSTOPB | CLOCAL | CREAD;
+  tio.c_iflag &= ~( IGNPAR | ISTRIP | IXON | IXOFF );
+  tio.c_iflag |= INPCK | PARMRK;
+  tio.c_cc[ VMIN ]  = 0;
+  tio.c_cc[ VTIME ] = 0;
+  tcsetattr( fd, TCSANOW, &tio );
+  tcflush( fd, TCIOFLUSH );
+
+  Attach( fd );
+  m_bOwnFd = true;
+  return true;
+}
+
+void JetiExTermiosReader::Attach( int fd )
+{
+  if( m_bOwnFd && m_fd >= 0 )
+    close( m_fd );
+  m_fd     = fd;
+  m_bOwnFd = false;
+  m_state  = 0;
+}
+
+int JetiExTermiosReader::Read( uint16_t * pSymbols, int maxSymbols )
+{
+  uint8_t buf[ 256 ];
+  int     n = maxSymbols < (int)sizeof( buf ) ? maxSymbols : (int)sizeof( buf );   // a symbol takes one byte at least
+  ssize_t r = read( m_fd, buf, n );
+  if( r < 0 )
+    return ( errno == EAGAIN || errno == EINTR ) ? 0 : -1;
+  return Decode( buf, r, pSymbols );
+}
+
+int JetiExTermiosReader::Decode( const uint8_t * pData, int n, uint16_t * pSymbols )
+{
+  int nSymbols = 0;
+  for( int i = 0; i < n; i++ )
+  {
+    uint8_t c = pData[ i ];
+    switch( m_state )
+    {
+    case 0:                                      // data
+      if( c == 0xFF )
+        m_state = 1;
+      else
+        pSymbols[ nSymbols++ ] = c;
+      break;
+    case 1:                                      // after 0xFF
+      if( c == 0xFF )
+      {
+        pSymbols[ nSymbols++ ] = 0xFF;
+        m_state = 0;
+      }
+      else
+        m_state = 2;                             // 0xFF 0x00: parity error follows
+      break;
+    case 2:
+      pSymbols[ nSymbols++ ] = 0x100 | c;
+      m_state = 0;
+      break;
+    }
+  }
+  return nSymbols;
+}
+
+bool JetiExTermiosReader::SendKey( uint8_t key )
+{
+  return write( m_fd, &key, 1 ) == 1;
+}
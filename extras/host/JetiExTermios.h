@@ -0,0 +1,121 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExTermios - serial port on Linux (POSIX termios), i.e. USB-UART on a companion computer
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  JetiExTermiosSerial runs JetiExProtocol on a Linux tty (-DJETIEX_HOST). 
+  The 9th bit is emulated by the parity bit: 8 data bits, mark/space parity (CMSPAR),
+  switched per symbol, 2 stop bits. Symbols with the same 9th bit are collected and 
+  written with a single write() call by Poll() (DoJetiSend()), parity switches wait
+  until the previous symbols have left the UART (TCSADRAIN).
+  Note: an 8 bit UART can't send the odd parity bit of 9O1 in addition to the 9th bit,
+  the first stop bit (mark) takes its place, a symbol takes 12 bits as on the EX link.
+  Keys are read without blocking. For a single wire connection (TX and RX tied together)
+  set bEcho, then the echo of the own symbols is discarded.
+
+  JetiExTermiosReader receives 9 bit symbols for tests (loopback with a 2nd USB-UART or a pty):
+  the tty is set to space parity with parity error marking (INPCK, PARMRK), so symbols
+  with 9th bit arrive as 0xFF 0x00 <data>.
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXTERMIOS_H
+#define JETIEXTERMIOS_H
+
+#include <termios.h>
+#include "JetiExSerial.h"
+
+// serial port for JetiExProtocol
+/////////////////////////////////
+class JetiExTermiosSerial : public JetiExSerial
+{
+public:
+  typedef struct
+  {
+    uint32_t nSymbols;     // symbols written
+    uint32_t nWrites;      // write() calls
+    uint32_t nSwitches;    // parity switches
+    uint32_t nErrors;      // write errors, symbols lost
+  }
+  Stats;
+
+  JetiExTermiosSerial( const char * pDevice, bool bEcho = false );
+  virtual ~JetiExTermiosSerial();
+
+  virtual void    Init();
+  virtual void    Send( uint8_t data, boolean bit8 );
+  virtual uint8_t Getchar(void);
+  virtual void    TxOn() {}
+  virtual void    TxOff() {}
+  virtual void    Poll() { Flush(); }
+
+  bool          IsOpen() const { return m_fd >= 0; }
+  void          Flush();                                     // write collected symbols
+  const Stats & GetStats() const { return m_stats; }
+
+protected:
+  virtual bool SetParity( bool bMark );                      // 9th bit of the following symbols
+  virtual bool Write( const uint8_t * pData, size_t n );
+
+  const char *   m_pDevice;
+  int            m_fd;
+  struct termios m_tio;
+  bool           m_bEcho;
+  uint32_t       m_nEcho;                                    // own symbols to be discarded from RX
+
+  // symbols with the same 9th bit
+  uint8_t        m_run[ 64 ];
+  uint8_t        m_nRun;
+  bool           m_bRunMark;
+  bool           m_bLineMark;                                // current parity of the tty
+
+  Stats          m_stats;
+};
+
+// receiver for tests
+/////////////////////
+class JetiExTermiosReader
+{
+public:
+  JetiExTermiosReader();
+  ~JetiExTermiosReader();
+
+  bool Open( const char * pDevice );                         // tty, space parity with PARMRK
+  void Attach( int fd );                                     // fd with PARMRK encoded input (i.e. pty master), not closed
+  int  Read( uint16_t * pSymbols, int maxSymbols );          // without blocking, symbol: bit 8 = 9th bit, -1: error
+  bool SendKey( uint8_t key );
+
+  // PARMRK decoding: 0xFF 0x00 c: c with 9th bit, 0xFF 0xFF: 0xFF
+  int  Decode( const uint8_t * pData, int n, uint16_t * pSymbols );
+
+protected:
+  int     m_fd;
+  bool    m_bOwnFd;
+  uint8_t m_state;                                           // position in 0xFF escape sequence
+};
+
+#endif // JETIEXTERMIOS_H
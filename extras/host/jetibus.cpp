@@ -0,0 +1,231 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetibus - EX Bus simulator: receiver polling, answer deadlines and telemetry throughput
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     -i receiver ISR, -e corrupted channel packets, channel latency
+                     -P frame pipeline
+
+  Usage:
+    jetibus [-t seconds] [-b 125|250] [-p periodUs] [-l loopUs] [-j jetiboxEvery] [-s sensors] [-e corruptEvery] [-i] [-P] [-v]
+
+    A JetiExBus instance runs on a virtual clock with JetiExBusSim as receiver:
+    every period (10 ms) a channel packet and a telemetry or Jetibox request (every
+    jetiboxEvery periods) are sent. loop() sets a new value for every sensor and calls
+    DoJetiSend() every loopUs. The answers are checked and decoded, the channel values
+    seen by the sensor are compared with the ones sent.
+    Prints missed/late answers, answer latency, channel latency (end of packet until
+    published) and values per second per sensor.
+    -e  bad crc in every n-th channel packet (lost packet counter)
+    -i  bytes are parsed in the receiver ISR instead of DoJetiSend()
+    -P  frame pipeline (SetFramePipeline()): the next EX frame is assembled between the requests
+    -v  print every decoded value
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetibus jetibus.cpp JetiExBusSim.cpp JetiExDecoder.cpp
+        ../../src/JetiExBus.cpp ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "JetiExBus.h"
+#include "JetiExBusSim.h"
+#include "JetiExDecoder.h"
+
+// count decoded values per sensor
+//////////////////////////////////
+class Receiver : public JetiExDecoderSink
+{
+public:
+  Receiver( bool bVerbose ) : m_bVerbose( bVerbose ), m_nText( 0 ) { memset( m_nValues, 0, sizeof( m_nValues ) ); }
+
+  virtual void OnValue( const JetiExValue & v, uint64_t tiUs )
+  {
+    if( m_bVerbose )
+      printf( "%10.3f id=%3d value=%d\n", tiUs / 1000.0, v.id, (int)v.value );
+    m_nValues[ v.id ]++;
+  }
+  virtual void OnText( const char * text, uint64_t tiUs ) { m_nText++; }
+
+  bool     m_bVerbose;
+  uint32_t m_nValues[ 256 ];
+  uint32_t m_nText;
+};
+
+static uint32_t Percentile( const std::vector<uint32_t> & v, int p )
+{
+  return v.empty() ? 0 : v[ ( v.size() - 1 ) * p / 100 ];
+}
+
+int main( int argc, char ** argv )
+{
+  bool     bVerbose     = false;
+  uint32_t seconds      = 60;
+  uint32_t periodUs     = 10000;
+  uint32_t loopUs       = 500;
+  uint32_t jetiboxEvery = 4;
+  uint32_t nSensors     = 16;
+  uint32_t corruptEvery = 0;
+  bool     bRxIsr       = false;
+  bool     bPipeline    = false;
+  JetiExBus::enBaud baud = JetiExBus::BAUD_125K;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-v" ) == 0 )
+      bVerbose = true;
+    else if( strcmp( argv[ i ], "-t" ) == 0 && i + 1 < argc )
+      seconds = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-b" ) == 0 && i + 1 < argc )
+      baud = atol( argv[ ++i ] ) == 250 ? JetiExBus::BAUD_250K : JetiExBus::BAUD_125K;
+    else if( strcmp( argv[ i ], "-p" ) == 0 && i + 1 < argc )
+      periodUs = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-l" ) == 0 && i + 1 < argc )
+      loopUs = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-j" ) == 0 && i + 1 < argc )
+      jetiboxEvery = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-s" ) == 0 && i + 1 < argc )
+      nSensors = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-e" ) == 0 && i + 1 < argc )
+      corruptEvery = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-i" ) == 0 )
+      bRxIsr = true;
+    else if( strcmp( argv[ i ], "-P" ) == 0 )
+      bPipeline = true;
+    else
+    {
+      fprintf( stderr, "usage: jetibus [-t seconds] [-b 125|250] [-p periodUs] [-l loopUs] [-j jetiboxEvery] [-s sensors] [-e corruptEvery] [-i] [-P] [-v]\n" );
+      return 1;
+    }
+  }
+  if( nSensors < 1 || nSensors > 31 || periodUs == 0 || loopUs == 0 )
+  {
+    fprintf( stderr, "sensors 1..31, period and loop > 0\n" );
+    return 1;
+  }
+
+  // sensor table
+  std::vector<JetiSensorConst> sensors;
+  for( uint32_t i = 1; i <= nSensors + 1; i++ )
+  {
+    JetiSensorConst s;
+    memset( &s, 0, sizeof( s ) );
+    if( i <= nSensors )
+    {
+      s.id       = i;
+      s.dataType = JetiSensor::TYPE_22b;
+      snprintf( s.text, sizeof( s.text ), "Sensor %u", i );
+    }
+    sensors.push_back( s );
+  }
+
+  JetiExVirtualClock clock;
+  JetiExClock::SetClock( &clock );
+
+  Receiver      receiver( bVerbose );
+  JetiExDecoder decoder( &receiver );
+  JetiExBusSim  sim( &decoder, periodUs, 16, jetiboxEvery );
+  JetiExBus     jetiEx;
+  sim.SetRxIsr( bRxIsr );
+  sim.SetCorruptEvery( corruptEvery );
+  jetiEx.SetFramePipeline( bPipeline );
+  jetiEx.Start( "EX Bus", &sensors[ 0 ], &sim, baud );
+
+  uint64_t tiEnd     = clock.Micros() + (uint64_t)seconds * 1000000;
+  int32_t  counter   = 0;
+  uint32_t nChannels = 0, nChannelErrors = 0, nKeysSent = 0, nKeys = 0;
+  std::vector<uint32_t> chLat;
+  JetiExBus::Channels   channels;
+  while( clock.Micros() < tiEnd )
+  {
+    // loop()
+    counter = ( counter + 1 ) % 1000;
+    for( uint32_t id = 1; id <= nSensors; id++ )
+      jetiEx.SetSensorValue( id, id * 1000 + counter );
+
+    if( ( clock.Micros() % 1000000 ) < loopUs )    // a key per second
+    {
+      sim.PushKey( JetiExProtocol::DOWN );
+      nKeysSent++;
+    }
+
+    jetiEx.DoJetiSend();
+
+    if( jetiEx.GetChannels( channels ) )
+    {
+      uint32_t cycle = sim.CycleAt( channels.tiUs );
+      nChannels++;
+      chLat.push_back( (uint32_t)( channels.tiUs - sim.ChannelEndUs( cycle ) ) );
+      for( uint8_t ch = 0; ch < channels.n; ch++ )
+        if( channels.values[ ch ] != sim.ChannelValue( cycle, ch ) )
+        {
+          nChannelErrors++;
+          break;
+        }
+    }
+    if( jetiEx.GetJetiboxKey() )
+      nKeys++;
+
+    if( bRxIsr )
+      sim.Update( clock, clock.Micros() + loopUs );
+    else
+      clock.Advance( loopUs );
+  }
+
+  // results
+  const JetiExBusSim::Stats & s  = sim.GetStats();
+  JetiExBus::Stats            bs = jetiEx.GetBusStats();
+  const JetiExDecoder::Stats & ds = decoder.GetStats();
+  std::vector<uint32_t> & lat = sim.GetLatencies();
+  std::sort( lat.begin(), lat.end() );
+  std::sort( chLat.begin(), chLat.end() );
+
+  printf( "%u s, %s kbaud, period %u us, loop %u us, %s: bus load %.1f %%\n", seconds, baud == JetiExBus::BAUD_250K ? "250" : "125",
+          periodUs, loopUs, bRxIsr ? "receiver ISR" : "polled", s.busyNs / 1e7 / seconds );
+  printf( "receiver: requests %u, answers %u, late %u, missing %u, collisions %u, errors %u\n",
+          s.nRequests, s.nAnswers, s.nLate, s.nMissing, s.nCollisions, s.nErrors );
+  printf( "answer latency us: p50 %u, p99 %u, max %u (deadline %u)\n", Percentile( lat, 50 ), Percentile( lat, 99 ),
+          lat.empty() ? 0 : lat.back(), (unsigned)JetiExBus::RESPONSE_US );
+  printf( "sensor: packets %u, channel packets %u (wrong %u), telemetry %u, jetibox %u, missed %u, lost %u (corrupted %u), keys %u/%u\n",
+          bs.nPackets, nChannels, nChannelErrors, bs.nTelemetry, bs.nJetibox, bs.nMissed, bs.nLost, s.nCorrupted, nKeys, nKeysSent );
+  printf( "channel latency us: p50 %u, p99 %u, max %u\n", Percentile( chLat, 50 ), Percentile( chLat, 99 ), chLat.empty() ? 0 : chLat.back() );
+  printf( "decoded: EX frames %u (values %u %%), values %u, text frames %u, errors %u\n",
+          ds.nExFrames, jetiEx.GetValueFrameRatio(), ds.nValues, receiver.m_nText, ds.nErrors );
+
+  printf( "\n   id   values/s   refresh ms\n" );
+  for( uint32_t id = 1; id <= nSensors; id++ )
+  {
+    double perSec = receiver.m_nValues[ id ] / (double)seconds;
+    printf( "  %3u %10.1f %12.1f\n", id, perSec, perSec > 0 ? 1000.0 / perSec : 0.0 );
+  }
+
+  JetiExClock::SetClock( 0 );
+  return 0;
+}
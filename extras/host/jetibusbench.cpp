@@ -0,0 +1,174 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetibusbench - EX Bus parser throughput
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetibusbench [-n packets] [-c channels] [-e corruptEvery]
+
+    Generates a receiver byte stream (channel packet and telemetry request per period,
+    every corruptEvery-th channel packet with bad crc) and measures the time per byte of
+    JetiExBusParser::Put() and of JetiExBus::OnReceive(), which is the receiver ISR:
+    crc16 update, channel value store and double buffer switch.
+    The packet counters are checked against the generated stream.
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetibusbench jetibusbench.cpp
+        ../../src/JetiExBus.cpp ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "JetiExBus.h"
+
+static void AddPacket( std::vector<uint8_t> & stream, uint8_t * pPacket, uint8_t len )
+{
+  uint16_t crc = JetiExBusParser::Crc16( pPacket, len - 2 );
+  pPacket[ len - 2 ] = crc & 0xFF;
+  pPacket[ len - 1 ] = crc >> 8;
+  stream.insert( stream.end(), pPacket, pPacket + len );
+}
+
+static double Seconds( const struct timespec & t0, const struct timespec & t1 )
+{
+  return ( t1.tv_sec - t0.tv_sec ) + ( t1.tv_nsec - t0.tv_nsec ) / 1e9;
+}
+
+int main( int argc, char ** argv )
+{
+  uint32_t nCycles      = 1000000;
+  uint32_t nChannels    = 16;
+  uint32_t corruptEvery = 100;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-n" ) == 0 && i + 1 < argc )
+      nCycles = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-c" ) == 0 && i + 1 < argc )
+      nChannels = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-e" ) == 0 && i + 1 < argc )
+      corruptEvery = atol( argv[ ++i ] );
+    else
+    {
+      fprintf( stderr, "usage: jetibusbench [-n packets] [-c channels] [-e corruptEvery]\n" );
+      return 1;
+    }
+  }
+  if( nCycles == 0 || nChannels < 1 || nChannels > JetiExBus::MAX_CHANNELS )
+  {
+    fprintf( stderr, "packets > 0, channels 1..%d\n", (int)JetiExBus::MAX_CHANNELS );
+    return 1;
+  }
+
+  // receiver stream
+  std::vector<uint8_t> stream;
+  uint8_t  packet[ JetiExBusParser::MAX_PACKET ];
+  uint8_t  packetId   = 0;
+  uint32_t nCorrupted = 0;
+  uint32_t lastValid  = 0, nLostValid = 0;          // last valid channel packet, packets lost before it
+  for( uint32_t cycle = 0; cycle < nCycles; cycle++ )
+  {
+    uint8_t len = 8 + 2 * nChannels;
+    packet[ 0 ] = JetiExBus::HDR_CHANNEL;
+    packet[ 1 ] = 0x03;
+    packet[ 2 ] = len;
+    packet[ 3 ] = packetId++;
+    packet[ 4 ] = JetiExBus::ID_CHANNEL;
+    packet[ 5 ] = 2 * nChannels;
+    for( uint8_t ch = 0; ch < nChannels; ch++ )
+    {
+      uint16_t value = 8000 + ( ( cycle * 8 + ch * 500 ) % 8000 );
+      packet[ 6 + 2 * ch ] = value & 0xFF;
+      packet[ 7 + 2 * ch ] = value >> 8;
+    }
+    AddPacket( stream, packet, len );
+    if( corruptEvery && ( cycle % corruptEvery ) == corruptEvery - 1 )
+    {
+      stream[ stream.size() - 5 ] ^= 0x55;
+      nCorrupted++;
+    }
+    else
+    {
+      lastValid  = cycle;
+      nLostValid = nCorrupted;
+    }
+
+    packet[ 0 ] = JetiExBus::HDR_REQUEST;
+    packet[ 1 ] = 0x01;
+    packet[ 2 ] = 8;
+    packet[ 3 ] = packetId++;
+    packet[ 4 ] = JetiExBus::ID_TELEMETRY;
+    packet[ 5 ] = 0;
+    AddPacket( stream, packet, 8 );
+  }
+  size_t nBytes = stream.size();
+
+  // micros() is called once per packet, keep the system clock out of the measurement
+  JetiExVirtualClock clock;
+  JetiExClock::SetClock( &clock );
+
+  struct timespec t0, t1;
+
+  // parser only
+  JetiExBusParser parser;
+  uint32_t        nValid = 0;
+  clock_gettime( CLOCK_MONOTONIC, &t0 );
+  for( size_t i = 0; i < nBytes; i++ )
+    nValid += parser.Put( stream[ i ] );
+  clock_gettime( CLOCK_MONOTONIC, &t1 );
+  double secParser = Seconds( t0, t1 );
+
+  // receiver ISR
+  JetiExBus jetiEx;
+  clock_gettime( CLOCK_MONOTONIC, &t0 );
+  for( size_t i = 0; i < nBytes; i++ )
+    jetiEx.OnReceive( stream[ i ] );
+  clock_gettime( CLOCK_MONOTONIC, &t1 );
+  double secIsr = Seconds( t0, t1 );
+
+  JetiExBus::Stats    bs = jetiEx.GetBusStats();
+  JetiExBus::Channels channels;
+  jetiEx.GetChannels( channels );
+  bool bOk = nValid == 2 * nCycles - nCorrupted && bs.nChannel == nCycles - nCorrupted && bs.nLost == nCorrupted &&
+             channels.nLost == nLostValid && channels.n == nChannels;
+  for( uint8_t ch = 0; ch < channels.n; ch++ )
+    if( channels.values[ ch ] != 8000 + ( ( lastValid * 8 + ch * 500 ) % 8000 ) )
+      bOk = false;
+
+  printf( "%u packets, %u channels, %.1f MB: valid %u, channel %u, lost %u (corrupted %u) %s\n", 2 * nCycles, nChannels,
+          nBytes / 1e6, nValid, bs.nChannel, bs.nLost, nCorrupted, bOk ? "ok" : "MISMATCH" );
+  printf( "JetiExBusParser::Put  %6.2f ns/byte %8.1f MB/s\n", secParser * 1e9 / nBytes, nBytes / 1e6 / secParser );
+  printf( "JetiExBus::OnReceive  %6.2f ns/byte %8.1f MB/s\n", secIsr * 1e9 / nBytes, nBytes / 1e6 / secIsr );
+  printf( "EX Bus 250 kbaud: %u bytes/s = %.4f %% CPU in OnReceive\n", 25000, 25000 * secIsr / nBytes * 100 );
+
+  JetiExClock::SetClock( 0 );
+  return bOk ? 0 : 2;
+}
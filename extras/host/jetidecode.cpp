@@ -0,0 +1,214 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetidecode - decode EX/Jetibox symbol streams and print refresh statistics
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetidecode [-v] [-s symbolTimeUs] <file|->
+
+    Input is a capture file (see JetiExCapture.h) or a raw stream of 9 bit symbols,
+    one little endian 16 bit word per symbol (bit 0..7 data, bit 8 = 9th bit).
+    Time is taken from the capture or derived from the symbol count.
+    -v  print every decoded frame
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetidecode jetidecode.cpp JetiExDecoder.cpp JetiExCapture.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "JetiExDecoder.h"
+#include "JetiExCapture.h"
+
+// print decoded frames
+///////////////////////
+class Printer : public JetiExDecoderSink
+{
+public:
+  Printer( JetiExDecoder * pDecoder ) : m_pDecoder( pDecoder ) {}
+
+  virtual void OnDictionary( const JetiExDictEntry & e, uint64_t tiUs )
+  {
+    printf( "%10.3f DICT  dev=%04X id=%3d \"%s\" [%s]\n", tiUs / 1000.0, e.devId, e.id, e.text, e.unit );
+  }
+
+  virtual void OnValue( const JetiExValue & v, uint64_t tiUs )
+  {
+    const JetiExDictEntry * pDict = m_pDecoder->GetDictionary( v.devId, v.id );
+    printf( "%10.3f VALUE dev=%04X id=%3d %-3s ", tiUs / 1000.0, v.devId, v.id, JetiExDecoder::TypeName( v.dataType ) );
+    if( v.dataType == 5 )
+    {
+      if( v.bDate )
+        printf( "%02d.%02d.%04d", v.dt[ 0 ], v.dt[ 1 ], v.dt[ 2 ] + 2000 );
+      else
+        printf( "%02d:%02d:%02d", v.dt[ 0 ], v.dt[ 1 ], v.dt[ 2 ] );
+    }
+    else if( v.dataType == 9 )
+      printf( "%.5f %s", v.gps, v.bLongitude ? "lon" : "lat" );
+    else
+      printf( "%.*f", v.precision, JetiExDecoder::ToDouble( v ) );
+    if( pDict )
+      printf( " %s (%s)", pDict->unit, pDict->text );
+    printf( "\n" );
+  }
+
+  virtual void OnAlarm( char code, bool bSound, uint64_t tiUs )
+  {
+    printf( "%10.3f ALARM '%c'%s\n", tiUs / 1000.0, code, bSound ? "" : " (silent)" );
+  }
+
+  virtual void OnExit( uint64_t tiUs )
+  {
+    printf( "%10.3f EXIT\n", tiUs / 1000.0 );
+  }
+
+  virtual void OnText( const char * text, uint64_t tiUs )
+  {
+    char line[ 33 ];
+    for( int i = 0; i < 32; i++ )
+      line[ i ] = ( text[ i ] >= 0x20 && text[ i ] < 0x7F ) ? text[ i ] : '.';
+    line[ 32 ] = '\0';
+    printf( "%10.3f TEXT  \"%.16s\" \"%.16s\"\n", tiUs / 1000.0, line, line + 16 );
+  }
+
+  virtual void OnError( uint8_t error, uint64_t tiUs )
+  {
+    printf( "%10.3f ERROR %d\n", tiUs / 1000.0, error );
+  }
+
+protected:
+  JetiExDecoder * m_pDecoder;
+};
+
+static void PrintStats( const JetiExDecoder & decoder, const JetiExRefreshStats & refresh )
+{
+  const JetiExDecoder::Stats & s = decoder.GetStats();
+  printf( "symbols: %llu, EX frames: %u (data %u, dictionary %u), values: %u, text frames: %u, alarms: %u, exits: %u, errors: %u (crc %u)\n",
+          (unsigned long long)s.nSymbols, s.nExFrames, s.nDataFrames, s.nDictFrames, s.nValues, s.nTextFrames, s.nAlarms, s.nExits, s.nErrors, s.nCrcErrors );
+
+  printf( "\n  dev   id type  label                    values  changes   avg ms   min ms   max ms\n" );
+  for( int i = 0; i < refresh.GetCount(); i++ )
+  {
+    const JetiExRefreshStats::Entry & e     = refresh.Get( i );
+    const JetiExDictEntry *           pDict = decoder.GetDictionary( e.devId, e.id );
+    printf( "  %04X %3d %-4s  %-22.22s %8u %8u %8.1f %8.1f %8.1f\n", e.devId, e.id, JetiExDecoder::TypeName( e.dataType ),
+            pDict ? pDict->text : "?", e.nValues, e.nChanges,
+            JetiExRefreshStats::AvgInterval( e ) / 1000.0,
+            e.nValues > 1 ? e.minInterval / 1000.0 : 0.0,
+            e.maxInterval / 1000.0 );
+  }
+}
+
+int main( int argc, char ** argv )
+{
+  bool         bVerbose = false;
+  uint32_t     symbolUs = JetiExDecoder::SYMBOL_US;
+  const char * pPath    = 0;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-v" ) == 0 )
+      bVerbose = true;
+    else if( strcmp( argv[ i ], "-s" ) == 0 && i + 1 < argc )
+      symbolUs = atoi( argv[ ++i ] );
+    else
+      pPath = argv[ i ];
+  }
+  if( pPath == 0 )
+  {
+    fprintf( stderr, "usage: jetidecode [-v] [-s symbolTimeUs] <file|->\n" );
+    return 1;
+  }
+
+  JetiExDecoder      decoder;
+  Printer            printer( &decoder );
+  JetiExRefreshStats refresh( bVerbose ? &printer : 0 );
+  decoder.SetSink( &refresh );
+  decoder.SetSymbolTime( symbolUs );
+
+  uint64_t nBytes = 0;
+  struct timespec t0, t1;
+  clock_gettime( CLOCK_MONOTONIC, &t0 );
+
+  if( strcmp( pPath, "-" ) != 0 && JetiExCaptureReader::IsCapture( pPath ) )
+  {
+    // capture: transmitted symbols with timestamps, session by session
+    JetiExCaptureReader reader;
+    JetiExCaptureRecord rec;
+    uint32_t            session = 0;
+    reader.Open( pPath );
+    while( reader.Next( rec ) )
+    {
+      if( rec.session != session )
+      {
+        PrintStats( decoder, refresh );
+        printf( "\n--- session %u\n", rec.session );
+        session = rec.session;
+      }
+      if( rec.kind <= JetiExCaptureWriter::REC_TX9 )
+      {
+        decoder.Put( rec.data | ( rec.kind == JetiExCaptureWriter::REC_TX9 ? 0x100 : 0 ), rec.tiUs );
+        nBytes += 2;
+      }
+      else if( rec.kind == JetiExCaptureWriter::REC_KEY && bVerbose )
+        printf( "%10.3f KEY   0x%02X\n", rec.tiUs / 1000.0, rec.data );
+    }
+  }
+  else
+  {
+    FILE * fp = strcmp( pPath, "-" ) == 0 ? stdin : fopen( pPath, "rb" );
+    if( fp == 0 )
+    {
+      perror( pPath );
+      return 1;
+    }
+
+    // decode in large blocks
+    enum { BLOCK_SYMBOLS = 1 << 20 };
+    uint16_t * pBlock = new uint16_t[ BLOCK_SYMBOLS ];
+    size_t     n;
+    while( ( n = fread( pBlock, sizeof( uint16_t ), BLOCK_SYMBOLS, fp ) ) > 0 )
+    {
+      decoder.Decode( pBlock, n );
+      nBytes += n * sizeof( uint16_t );
+    }
+
+    delete [] pBlock;
+    if( fp != stdin )
+      fclose( fp );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, &t1 );
+  double sec = ( t1.tv_sec - t0.tv_sec ) + ( t1.tv_nsec - t0.tv_nsec ) / 1e9;
+
+  PrintStats( decoder, refresh );
+  fprintf( stderr, "\n%.1f MB symbols in %.3f s: %.1f MB/s\n", nBytes / 1e6, sec, sec > 0 ? nBytes / 1e6 / sec : 0.0 );
+  return 0;
+}
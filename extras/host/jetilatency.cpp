@@ -0,0 +1,477 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetilatency - end-to-end latency simulator: SetSensorValue() until the value has left the UART
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     value timeouts (-e, timeout), sensor stop time, received values per second
+                     -H health device
+                     -R wire id remapping
+                     -P frame pipeline
+
+  Usage:
+    jetilatency [-t seconds] [-l loopUs] [-b baud] [-r ringSize] [-i] [-k keepAliveMs] [-d wrap|once|trickle[:frames]] [-e timeoutMs] [-H] [-R] [-P leadMs] [-v] [script]
+
+    A JetiExProtocol instance runs on a virtual clock (faster than real time) with a
+    JetiExUartModel as serial port (9800 bps, 9O1, 70 symbol ring buffer by default).
+    The workload sets a new, unique value for every sensor with its own period,
+    the transmitted stream is decoded again and every received value is matched
+    with its SetSensorValue() call. Latency ends with the last bit of the EX frame
+    carrying the value. Values overwritten before they were sent are counted as lost.
+    -i  timer mode: frames are sent from a 1 ms timer tick (StartTimer()/OnTimerTick()),
+        loop() only sets values
+    -k  text frame on change only, keep alive interval in ms (SetJetiboxTextRefresh())
+    -d  dictionary refresh policy (SetDictionaryRefresh())
+    -e  value timeout for all sensors (SetSensorTimeout())
+    -H  health device (AddHealthDevice(), 1 s interval): GetHealth() and the last received health values
+    -R  wire id remapping (SetIdRemap()), the sensors with the shortest period get the lowest ids
+    -P  frame pipeline (SetFramePipeline()), the next frame is assembled during the last leadMs
+
+    Script (one statement per line, # starts a comment):
+      sensor <id> <6b|14b|22b|30b> <periodMs> [phaseMs [stopSeconds]]   stop: no more values (sensor failure)
+      duration <seconds>
+      loop <us>          period of loop() calling DoJetiSend()
+      baud <bps>
+      ring <symbols>
+      timer <0|1>        timer mode
+      text <ms>          text frame keep alive interval, 0: text with every frame
+      timeout <ms>       value timeout
+    Without script: 8 sensors, 14b, 100 ms period.
+    Command line options override the script.
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetilatency jetilatency.cpp JetiExSim.cpp JetiExDecoder.cpp
+        ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "JetiExProtocol.h"
+#include "JetiExSim.h"
+#include "JetiExDecoder.h"
+
+// workload of one sensor
+/////////////////////////
+typedef struct
+{
+  uint8_t  id;
+  uint8_t  dataType;
+  uint32_t periodUs;
+  uint32_t phaseUs;
+  int32_t  maxValue;   // values count up to maxValue and wrap to -maxValue
+  uint32_t stopUs;     // no more values after stopUs, 0: never
+}
+Workload;
+
+// pending values and results of one sensor
+///////////////////////////////////////////
+class SensorStats
+{
+public:
+  enum { MAX_PENDING = 16 };
+
+  SensorStats() : m_nSet( 0 ), m_nLost( 0 ), m_nRx( 0 ), m_nPending( 0 ) {}
+
+  void Set( int32_t value, uint64_t tiUs )
+  {
+    if( m_nPending == MAX_PENDING )   // too many unsent values: oldest is lost
+    {
+      Drop( 1 );
+      m_nLost++;
+    }
+    m_pending[ m_nPending ].value = value;
+    m_pending[ m_nPending ].tiUs  = tiUs;
+    m_nPending++;
+    m_nSet++;
+  }
+
+  void Received( int32_t value, uint64_t tiUs )
+  {
+    m_nRx++;
+    for( int i = 0; i < m_nPending; i++ )
+    {
+      if( m_pending[ i ].value == value )
+      {
+        m_latencies.push_back( (uint32_t)( tiUs - m_pending[ i ].tiUs ) );
+        m_nLost += i;               // older values were overwritten before they were sent
+        Drop( i + 1 );
+        return;
+      }
+    }
+    // repetition of a value, which was already received
+  }
+
+  uint32_t Percentile( int p )       // m_latencies must be sorted
+  {
+    if( m_latencies.empty() )
+      return 0;
+    size_t rank = ( m_latencies.size() * p + 99 ) / 100;
+    return m_latencies[ rank > 0 ? rank - 1 : 0 ];
+  }
+
+  std::vector<uint32_t> m_latencies;
+  uint32_t              m_nSet;
+  uint32_t              m_nLost;
+  uint32_t              m_nRx;       // received values incl. repetitions
+
+protected:
+  void Drop( int n )
+  {
+    memmove( m_pending, m_pending + n, ( m_nPending - n ) * sizeof( m_pending[ 0 ] ) );
+    m_nPending -= n;
+  }
+
+  struct { int32_t value; uint64_t tiUs; } m_pending[ MAX_PENDING ];
+  int m_nPending;
+};
+
+// receiver: decode the UART output and match values
+////////////////////////////////////////////////////
+class Receiver : public JetiExUartSink, public JetiExDecoderSink
+{
+public:
+  Receiver( bool bVerbose ) : m_decoder( this ), m_bVerbose( bVerbose )
+  {
+    memset( m_health, 0, sizeof( m_health ) );
+    for( int id = 0; id < 256; id++ )
+      m_appId[ id ] = id;
+  }
+
+  virtual void OnSymbol( uint16_t symbol, uint64_t tiEndUs ) { m_decoder.Put( symbol, tiEndUs ); }
+
+  virtual void OnValue( const JetiExValue & v, uint64_t tiUs )
+  {
+    if( m_bVerbose )
+      printf( "%10.3f id=%3d value=%d\n", tiUs / 1000.0, v.id, (int)v.value );
+    if( v.devId == HEALTH_DEVID )
+    {
+      if( v.id < 8 )
+        m_health[ v.id ] = v.value;
+      return;
+    }
+    m_sensors[ m_appId[ v.id ] ].Received( v.value, tiUs );
+  }
+
+  enum { HEALTH_DEVID = 0x3277 };   // health device, default device id is 0x3276
+
+  JetiExDecoder m_decoder;
+  SensorStats   m_sensors[ 256 ];
+  bool          m_bVerbose;
+  int32_t       m_health[ 8 ];   // last received health value per id
+  uint8_t       m_appId[ 256 ];  // wire id to sensor id
+};
+
+static bool ByPeriod( const Workload & a, const Workload & b )
+{
+  return a.periodUs < b.periodUs;
+}
+
+static bool ParseType( const char * s, Workload & w )
+{
+  if( strcmp( s, "6b" ) == 0 )       { w.dataType = JetiSensor::TYPE_6b;  w.maxValue = 31; }
+  else if( strcmp( s, "14b" ) == 0 ) { w.dataType = JetiSensor::TYPE_14b; w.maxValue = 8191; }
+  else if( strcmp( s, "22b" ) == 0 ) { w.dataType = JetiSensor::TYPE_22b; w.maxValue = 2097151; }
+  else if( strcmp( s, "30b" ) == 0 ) { w.dataType = JetiSensor::TYPE_30b; w.maxValue = 536870911; }
+  else
+    return false;
+  return true;
+}
+
+static bool ReadScript( const char * path, std::vector<Workload> & workload, uint32_t & seconds, uint32_t & loopUs, uint32_t & baud, uint32_t & ringSize, bool & bTimer, uint32_t & keepAlive,
+                        uint32_t & timeout )
+{
+  FILE * fp = fopen( path, "r" );
+  if( fp == 0 )
+  {
+    perror( path );
+    return false;
+  }
+
+  char line[ 256 ];
+  int  lineNo = 0;
+  while( fgets( line, sizeof( line ), fp ) )
+  {
+    lineNo++;
+    char * p = strchr( line, '#' );
+    if( p )
+      *p = '\0';
+
+    char     cmd[ 16 ], type[ 8 ];
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    int      n = sscanf( line, "%15s", cmd );
+    if( n < 1 )
+      continue;
+
+    bool bOk = false;
+    if( strcmp( cmd, "sensor" ) == 0 && ( n = sscanf( line, "%*s %u %7s %u %u %u", &a, type, &b, &c, &d ) ) >= 3 )
+    {
+      Workload w;
+      w.id       = a;
+      w.periodUs = b * 1000;
+      w.phaseUs  = n > 3 ? c * 1000 : 0;
+      w.stopUs   = n > 4 ? d * 1000000 : 0;
+      bOk        = a > 0 && a < 256 && b > 0 && ParseType( type, w );
+      if( bOk )
+        workload.push_back( w );
+    }
+    else if( sscanf( line, "%*s %u", &a ) == 1 )
+    {
+      bOk = true;
+      if( strcmp( cmd, "duration" ) == 0 )  seconds  = a;
+      else if( strcmp( cmd, "loop" ) == 0 ) loopUs   = a;
+      else if( strcmp( cmd, "baud" ) == 0 ) baud     = a;
+      else if( strcmp( cmd, "ring" ) == 0 ) ringSize = a;
+      else if( strcmp( cmd, "timer" ) == 0 ) bTimer = a != 0;
+      else if( strcmp( cmd, "text" ) == 0 ) keepAlive = a;
+      else if( strcmp( cmd, "timeout" ) == 0 ) timeout = a;
+      else
+        bOk = false;
+    }
+
+    if( !bOk )
+    {
+      fprintf( stderr, "%s(%d): syntax error\n", path, lineNo );
+      fclose( fp );
+      return false;
+    }
+  }
+  fclose( fp );
+  return true;
+}
+
+int main( int argc, char ** argv )
+{
+  const char * pScript  = 0;
+  bool         bVerbose = false;
+  bool         bTimer   = false;
+  bool         optTimer = false;
+  uint32_t     seconds  = 60;
+  uint32_t     loopUs   = 1000;
+  uint32_t     baud     = 9800;
+  uint32_t     ringSize = 70;
+  uint32_t     keepAlive = 0;
+  uint32_t     timeout  = 0;
+  JetiExProtocol::enDictRefresh dictRefresh = JetiExProtocol::DICT_REFRESH_WRAP;
+  uint8_t      dictTrickle = 16;
+  bool         bHealth  = false;
+  bool         bRemap   = false;
+  long         pipeLead = -1;
+  long         optSeconds = -1, optLoopUs = -1, optBaud = -1, optRing = -1, optKeepAlive = -1, optTimeout = -1;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-v" ) == 0 )
+      bVerbose = true;
+    else if( strcmp( argv[ i ], "-t" ) == 0 && i + 1 < argc )
+      optSeconds = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-l" ) == 0 && i + 1 < argc )
+      optLoopUs = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-b" ) == 0 && i + 1 < argc )
+      optBaud = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-r" ) == 0 && i + 1 < argc )
+      optRing = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-i" ) == 0 )
+      optTimer = true;
+    else if( strcmp( argv[ i ], "-k" ) == 0 && i + 1 < argc )
+      optKeepAlive = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-d" ) == 0 && i + 1 < argc )
+    {
+      const char * pPolicy = argv[ ++i ];
+      if( strncmp( pPolicy, "trickle", 7 ) == 0 )
+      {
+        dictRefresh = JetiExProtocol::DICT_REFRESH_TRICKLE;
+        if( pPolicy[ 7 ] == ':' )
+          dictTrickle = atoi( pPolicy + 8 );
+      }
+      else if( strcmp( pPolicy, "once" ) == 0 )
+        dictRefresh = JetiExProtocol::DICT_REFRESH_ONCE;
+    }
+    else if( strcmp( argv[ i ], "-e" ) == 0 && i + 1 < argc )
+      optTimeout = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-H" ) == 0 )
+      bHealth = true;
+    else if( strcmp( argv[ i ], "-R" ) == 0 )
+      bRemap = true;
+    else if( strcmp( argv[ i ], "-P" ) == 0 && i + 1 < argc )
+      pipeLead = atol( argv[ ++i ] );
+    else if( argv[ i ][ 0 ] == '-' )
+    {
+      fprintf( stderr, "usage: jetilatency [-t seconds] [-l loopUs] [-b baud] [-r ringSize] [-i] [-k keepAliveMs] [-d wrap|once|trickle[:frames]] [-e timeoutMs] [-H] [-R] [-P leadMs] [-v] [script]\n" );
+      return 1;
+    }
+    else
+      pScript = argv[ i ];
+  }
+
+  std::vector<Workload> workload;
+  if( pScript && !ReadScript( pScript, workload, seconds, loopUs, baud, ringSize, bTimer, keepAlive, timeout ) )
+    return 1;
+  if( workload.empty() )
+  {
+    for( uint8_t id = 1; id <= 8; id++ )
+    {
+      Workload w;
+      w.id       = id;
+      w.periodUs = 100000;
+      w.phaseUs  = 0;
+      w.stopUs   = 0;
+      ParseType( "14b", w );
+      workload.push_back( w );
+    }
+  }
+  if( optSeconds > 0 ) seconds  = optSeconds;
+  if( optLoopUs > 0 )  loopUs   = optLoopUs;
+  if( optBaud > 0 )    baud     = optBaud;
+  if( optRing > 0 )    ringSize = optRing;
+  if( optTimer )       bTimer   = true;
+  if( optKeepAlive >= 0 ) keepAlive = optKeepAlive;
+  if( optTimeout >= 0 ) timeout   = optTimeout;
+
+  // sensor table from workload
+  std::vector<JetiSensorConst> sensors;
+  for( size_t i = 0; i < workload.size(); i++ )
+  {
+    JetiSensorConst s;
+    memset( &s, 0, sizeof( s ) );
+    s.id       = workload[ i ].id;
+    s.dataType = workload[ i ].dataType;
+    snprintf( s.text, sizeof( s.text ), "Sensor %d", s.id );
+    sensors.push_back( s );
+  }
+  JetiSensorConst endMark;
+  memset( &endMark, 0, sizeof( endMark ) );
+  sensors.push_back( endMark );
+
+  JetiExVirtualClock clock;
+  JetiExClock::SetClock( &clock );
+
+  Receiver        receiver( bVerbose );
+  JetiExUartModel uart( &receiver, baud, 12, ringSize );
+  JetiExProtocol  jetiEx;
+  jetiEx.SetJetiboxTextRefresh( keepAlive );
+  jetiEx.SetDictionaryRefresh( dictRefresh, dictTrickle );
+  if( bHealth )
+    jetiEx.AddHealthDevice( "Health", Receiver::HEALTH_DEVID & 0xFF, Receiver::HEALTH_DEVID >> 8, 1000 );
+  std::vector<uint8_t> fastIds;
+  if( bRemap )
+  {
+    // all sensors by period, the decoder sees wire id n for the n-th fastest sensor
+    std::vector<Workload> byRate( workload );
+    std::stable_sort( byRate.begin(), byRate.end(), ByPeriod );
+    for( size_t i = 0; i < byRate.size(); i++ )
+    {
+      fastIds.push_back( byRate[ i ].id );
+      receiver.m_appId[ i + 1 ] = byRate[ i ].id;
+    }
+    fastIds.push_back( 0 );
+    jetiEx.SetIdRemap( true, &fastIds[ 0 ] );
+  }
+  if( pipeLead >= 0 )
+    jetiEx.SetFramePipeline( true, pipeLead );
+  jetiEx.Start( "Latency", &sensors[ 0 ], &uart );
+  jetiEx.SetSensorTimeout( 0, timeout );
+  if( bTimer )
+    jetiEx.StartTimer();   // no built-in timer on host: OnTimerTick() is called below
+
+  // loop(): set values which are due, then DoJetiSend(); timer mode: 1 ms tick in between
+  std::vector<uint64_t> tiNext( workload.size() );
+  std::vector<int32_t>  values( workload.size(), 0 );
+  for( size_t i = 0; i < workload.size(); i++ )
+    tiNext[ i ] = clock.Micros() + workload[ i ].phaseUs;
+
+  uint64_t tiStart = clock.Micros();
+  uint64_t tiEnd  = clock.Micros() + (uint64_t)seconds * 1000000;
+  uint64_t tiLoop = clock.Micros();
+  uint64_t tiTick = clock.Micros();
+  while( clock.Micros() < tiEnd )
+  {
+    uint64_t tiNow = clock.Micros();
+    if( bTimer && tiNow >= tiTick )
+    {
+      jetiEx.OnTimerTick();
+      tiTick += 1000;
+    }
+    if( tiNow < tiLoop )
+    {
+      uart.Update( tiNow );
+      clock.Set( bTimer && tiTick < tiLoop ? tiTick : tiLoop );
+      continue;
+    }
+    tiLoop += loopUs;
+
+    for( size_t i = 0; i < workload.size(); i++ )
+    {
+      const Workload & w = workload[ i ];
+      if( tiNow < tiNext[ i ] || ( w.stopUs && tiNow - tiStart >= w.stopUs ) )
+        continue;
+      values[ i ] = values[ i ] >= w.maxValue ? -w.maxValue : values[ i ] + 1;
+      jetiEx.SetSensorValue( w.id, values[ i ] );
+      receiver.m_sensors[ w.id ].Set( values[ i ], tiNow );
+      tiNext[ i ] += w.periodUs;
+    }
+
+    jetiEx.DoJetiSend();
+    uart.Update( clock.Micros() );
+    clock.Set( bTimer && tiTick < tiLoop ? tiTick : tiLoop );
+  }
+  uart.Update( clock.Micros() + 1000000 );   // flush UART
+
+  // results
+  const JetiExUartModel::Stats & us = uart.GetStats();
+  const JetiExDecoder::Stats &   ds = receiver.m_decoder.GetStats();
+  printf( "%u s, loop %u us%s, text keep alive %u ms, value timeout %u ms, %u bps, ring buffer %u: line busy %.1f %%, ring buffer max %u, overflows %u, EX frames %u (values %u %%), errors %u\n",
+          seconds, loopUs, bTimer ? " (timer mode)" : "", keepAlive, timeout, baud, ringSize, us.busyNs / 1e7 / seconds, us.highWater, us.nOverflow, ds.nExFrames,
+          jetiEx.GetValueFrameRatio(), ds.nErrors );
+
+  printf( "\n   id type  period   values   sent   lost   p50 ms   p90 ms   p99 ms   max ms    rx/s\n" );
+  for( size_t i = 0; i < workload.size(); i++ )
+  {
+    const Workload & w = workload[ i ];
+    SensorStats &    s = receiver.m_sensors[ w.id ];
+    std::sort( s.m_latencies.begin(), s.m_latencies.end() );
+    printf( "  %3d %-4s %7.1f %8u %6u %6u %8.1f %8.1f %8.1f %8.1f %7.1f\n", w.id, JetiExDecoder::TypeName( w.dataType ), w.periodUs / 1000.0,
+            s.m_nSet, (unsigned)s.m_latencies.size(), s.m_nLost,
+            s.Percentile( 50 ) / 1000.0, s.Percentile( 90 ) / 1000.0, s.Percentile( 99 ) / 1000.0,
+            s.m_latencies.empty() ? 0.0 : s.m_latencies.back() / 1000.0, s.m_nRx / (double)seconds );
+  }
+
+  if( bHealth )
+  {
+    JetiExProtocol::Health h;
+    jetiEx.GetHealth( h );
+    const int32_t * r = receiver.m_health;
+    printf( "\nhealth (last window / received): link load %u / %d %%, value refresh %u / %d ms, TX buffer max %u / %d, TX overflows %u / %d, loop jitter %.1f / %.1f ms, loop max %.1f / %.1f ms\n",
+            h.linkLoad, r[ JetiExProtocol::HEALTH_LINK ], h.refreshMs, r[ JetiExProtocol::HEALTH_REFRESH ], h.txHighWater, r[ JetiExProtocol::HEALTH_TXHIGH ],
+            h.txOverflows, r[ JetiExProtocol::HEALTH_OVERFLOW ], h.loopJitterUs / 1000.0, r[ JetiExProtocol::HEALTH_JITTER ] / 10.0,
+            h.loopMaxUs / 1000.0, r[ JetiExProtocol::HEALTH_LOOPMAX ] / 10.0 );
+  }
+
+  JetiExClock::SetClock( 0 );
+  return 0;
+}
@@ -0,0 +1,388 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetiload - parallel multi-device load generator for decoder and gateway benchmarks
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetiload [-n instances] [-j threads] [-t seconds] [-l loopUs] [-s maxSensors] [-r seed] [-f cap|raw] [-o pathPattern] [-d]
+
+    Runs independent JetiExProtocol instances on a pool of threads, every instance with
+    its own virtual clock (JetiExClock::SetClock() is per thread), its own device id and a
+    random sensor table (all data types, 0..2 decimals, period 20..1000 ms) with a random
+    walk of values. The simulated time runs as fast as possible, the aggregate frames/s
+    and symbols/s are printed.
+    -o  output per instance, printf pattern with the instance number (i.e. out/dev%03d.cap),
+        files or FIFOs (mkfifo) of the gateway under test
+    -f  output format: capture file (default) or raw 16 bit symbols (jetidecode -)
+    -d  decode every stream in the generating thread (JetiExDecoder) and check frame counts
+    The same seed generates the same streams, independent of the number of threads.
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetiload jetiload.cpp JetiExCapture.cpp JetiExDecoder.cpp
+        ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp -pthread
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "JetiExProtocol.h"
+#include "JetiExCapture.h"
+#include "JetiExDecoder.h"
+
+// output of one instance: symbol counters, capture or raw stream, decoder
+//////////////////////////////////////////////////////////////////////////
+class LoadPort : public JetiExSerial
+{
+public:
+  LoadPort( JetiExCaptureWriter * pCapture, FILE * pRaw, JetiExDecoder * pDecoder )
+    : m_pCapture( pCapture ), m_pRaw( pRaw ), m_pDecoder( pDecoder ), m_nSymbols( 0 ), m_nExFrames( 0 ), m_nTextFrames( 0 ) {}
+
+  virtual void Init()
+  {
+    if( m_pCapture )
+      m_pCapture->Mark( micros() );
+  }
+
+  virtual void Send( uint8_t data, boolean bit8 )
+  {
+    m_nSymbols++;
+    if( !bit8 && data == 0x7E )
+      m_nExFrames++;
+    else if( !bit8 && data == 0xFE )
+      m_nTextFrames++;
+
+    if( m_pCapture )
+      m_pCapture->Write( bit8 ? JetiExCaptureWriter::REC_TX9 : JetiExCaptureWriter::REC_TX, data, micros() );
+    if( m_pRaw )
+    {
+      uint8_t word[ 2 ] = { data, (uint8_t)( bit8 ? 1 : 0 ) };   // little endian, bit 8 = 9th bit
+      fwrite( word, 1, sizeof( word ), m_pRaw );
+    }
+    if( m_pDecoder )
+      m_pDecoder->Put( bit8 ? 0x100 | data : data, micros() );
+  }
+
+  virtual uint8_t Getchar(void) { return 0; }
+  virtual void    TxOn() {}
+  virtual void    TxOff() {}
+
+  JetiExCaptureWriter * m_pCapture;
+  FILE *                m_pRaw;
+  JetiExDecoder *       m_pDecoder;
+  uint64_t              m_nSymbols;
+  uint32_t              m_nExFrames;
+  uint32_t              m_nTextFrames;
+};
+
+// configuration and result of one instance
+///////////////////////////////////////////
+typedef struct
+{
+  uint32_t seconds;
+  uint32_t loopUs;
+  uint32_t maxSensors;
+  uint32_t seed;
+  bool     bRaw;
+  bool     bDecode;
+  const char * pPattern;
+}
+Config;
+
+typedef struct
+{
+  bool     bOk;          // output could be opened, decoded frames match
+  uint32_t nSensors;
+  uint64_t nSymbols;
+  uint32_t nExFrames;
+  uint32_t nTextFrames;
+  uint32_t nValues;      // SetSensorValue() calls
+  uint32_t nDecodedFrames;
+  uint32_t nDecodedValues;
+  uint32_t nErrors;
+}
+Result;
+
+typedef struct
+{
+  uint8_t  id;
+  uint8_t  dataType;
+  uint32_t periodUs;
+  uint64_t tiNext;
+  int32_t  value;
+  int32_t  maxValue;
+}
+Workload;
+
+static void RunInstance( const Config & cfg, uint32_t instance, Result & result )
+{
+  static const uint8_t types[] = { JetiSensor::TYPE_6b, JetiSensor::TYPE_14b, JetiSensor::TYPE_22b, JetiSensor::TYPE_DT, JetiSensor::TYPE_30b, JetiSensor::TYPE_GPS };
+
+  memset( &result, 0, sizeof( result ) );
+  std::mt19937 rng( cfg.seed * 1000003u + instance );
+
+  // random sensor table: distinct ids 1..31
+  uint8_t ids[ 31 ];
+  for( uint8_t i = 0; i < 31; i++ )
+    ids[ i ] = i + 1;
+  std::shuffle( ids, ids + 31, rng );
+
+  uint32_t nSensors = 1 + rng() % cfg.maxSensors;
+  std::vector<JetiSensorConst> sensors( nSensors + 1 );
+  std::vector<Workload>        workload( nSensors );
+  memset( &sensors[ 0 ], 0, sensors.size() * sizeof( JetiSensorConst ) );
+  for( uint32_t i = 0; i < nSensors; i++ )
+  {
+    JetiSensorConst & s = sensors[ i ];
+    Workload &        w = workload[ i ];
+    s.id        = ids[ i ];
+    s.dataType  = types[ rng() % sizeof( types ) ];
+    s.precision = ( s.dataType == JetiSensor::TYPE_DT || s.dataType == JetiSensor::TYPE_GPS ) ? 0 : rng() % 3;
+    snprintf( s.text, sizeof( s.text ), "Load %u", s.id );
+    snprintf( s.unit, sizeof( s.unit ), "%c", 'a' + (char)( rng() % 26 ) );
+
+    w.id       = s.id;
+    w.dataType = s.dataType;
+    w.periodUs = 1000 * ( 20 + rng() % 981 );
+    w.tiNext   = rng() % w.periodUs;
+    w.value    = 0;
+    switch( s.dataType )
+    {
+    case JetiSensor::TYPE_6b:  w.maxValue = 31; break;
+    case JetiSensor::TYPE_14b: w.maxValue = 8191; break;
+    case JetiSensor::TYPE_22b: w.maxValue = 2097151; break;
+    default:                   w.maxValue = 536870911; break;
+    }
+  }
+  result.nSensors = nSensors;
+
+  // output
+  char                path[ 256 ] = "";
+  JetiExCaptureWriter capture;
+  FILE *              fpRaw = 0;
+  if( cfg.pPattern )
+  {
+    snprintf( path, sizeof( path ), cfg.pPattern, instance );
+    if( cfg.bRaw )
+    {
+      fpRaw = fopen( path, "wb" );
+      if( fpRaw == 0 )
+      {
+        perror( path );
+        return;
+      }
+    }
+    else if( !capture.Open( path ) )
+    {
+      fprintf( stderr, "%s: can't open capture\n", path );
+      return;
+    }
+  }
+  JetiExDecoder decoder;
+
+  JetiExVirtualClock clock;
+  JetiExClock::SetClock( &clock );
+  {
+    LoadPort       port( capture.IsOpen() ? &capture : 0, fpRaw, cfg.bDecode ? &decoder : 0 );
+    JetiExProtocol jetiEx;
+    jetiEx.SetDeviceId( instance & 0xFF, 0x40 | ( ( instance >> 8 ) & 0x3F ) );
+    jetiEx.Start( "Load", &sensors[ 0 ], &port );
+
+    // loop(): values which are due, then DoJetiSend()
+    uint64_t tiEnd = clock.Micros() + (uint64_t)cfg.seconds * 1000000;
+    while( clock.Micros() < tiEnd )
+    {
+      uint64_t tiNow = clock.Micros();
+      for( uint32_t i = 0; i < nSensors; i++ )
+      {
+        Workload & w = workload[ i ];
+        if( tiNow < w.tiNext )
+          continue;
+        w.tiNext += w.periodUs;
+        result.nValues++;
+
+        switch( w.dataType )
+        {
+        case JetiSensor::TYPE_DT:
+          if( w.id & 1 )
+            jetiEx.SetSensorValueDate( w.id, 1 + rng() % 28, 1 + rng() % 12, 2000 + rng() % 100 );
+          else
+            jetiEx.SetSensorValueTime( w.id, rng() % 24, rng() % 60, rng() % 60 );
+          break;
+        case JetiSensor::TYPE_GPS:
+          jetiEx.SetSensorValueGPS( w.id, ( w.id & 1 ) != 0, ( (int32_t)( rng() % 360000000 ) - 180000000 ) / 1e6f );
+          break;
+        default:
+          w.value += (int32_t)( rng() % 21 ) - 10;
+          if( w.value > w.maxValue || w.value < -w.maxValue )
+            w.value = 0;
+          jetiEx.SetSensorValue( w.id, w.value );
+          break;
+        }
+      }
+
+      jetiEx.DoJetiSend();
+      clock.Advance( cfg.loopUs );
+    }
+
+    result.nSymbols    = port.m_nSymbols;
+    result.nExFrames   = port.m_nExFrames;
+    result.nTextFrames = port.m_nTextFrames;
+  }
+  JetiExClock::SetClock( 0 );
+
+  if( fpRaw )
+    fclose( fpRaw );
+  capture.Close();
+
+  result.bOk = true;
+  if( cfg.bDecode )
+  {
+    const JetiExDecoder::Stats & ds = decoder.GetStats();
+    result.nDecodedFrames = ds.nExFrames;
+    result.nDecodedValues = ds.nValues;
+    result.nErrors        = ds.nErrors;
+    result.bOk            = ds.nErrors == 0 && ds.nExFrames == result.nExFrames;
+  }
+}
+
+static double Seconds( const struct timespec & t0, const struct timespec & t1 )
+{
+  return ( t1.tv_sec - t0.tv_sec ) + ( t1.tv_nsec - t0.tv_nsec ) / 1e9;
+}
+
+int main( int argc, char ** argv )
+{
+  Config   cfg;
+  uint32_t nInstances = 64;
+  uint32_t nThreads   = std::thread::hardware_concurrency();
+  cfg.seconds    = 600;
+  cfg.loopUs     = 1000;
+  cfg.maxSensors = 31;
+  cfg.seed       = 1;
+  cfg.bRaw       = false;
+  cfg.bDecode    = false;
+  cfg.pPattern   = 0;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-n" ) == 0 && i + 1 < argc )
+      nInstances = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-j" ) == 0 && i + 1 < argc )
+      nThreads = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-t" ) == 0 && i + 1 < argc )
+      cfg.seconds = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-l" ) == 0 && i + 1 < argc )
+      cfg.loopUs = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-s" ) == 0 && i + 1 < argc )
+      cfg.maxSensors = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-r" ) == 0 && i + 1 < argc )
+      cfg.seed = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-f" ) == 0 && i + 1 < argc )
+      cfg.bRaw = strcmp( argv[ ++i ], "raw" ) == 0;
+    else if( strcmp( argv[ i ], "-o" ) == 0 && i + 1 < argc )
+      cfg.pPattern = argv[ ++i ];
+    else if( strcmp( argv[ i ], "-d" ) == 0 )
+      cfg.bDecode = true;
+    else
+    {
+      fprintf( stderr, "usage: jetiload [-n instances] [-j threads] [-t seconds] [-l loopUs] [-s maxSensors] [-r seed] [-f cap|raw] [-o pathPattern] [-d]\n" );
+      return 1;
+    }
+  }
+  if( nInstances == 0 || cfg.seconds == 0 || cfg.loopUs == 0 || cfg.maxSensors < 1 || cfg.maxSensors > 31 )
+  {
+    fprintf( stderr, "instances, seconds and loop > 0, sensors 1..31\n" );
+    return 1;
+  }
+  if( cfg.pPattern && nInstances > 1 && strchr( cfg.pPattern, '%' ) == 0 )
+  {
+    fprintf( stderr, "output pattern needs the instance number (%%d) for more than one instance\n" );
+    return 1;
+  }
+  if( nThreads == 0 )
+    nThreads = 1;
+  if( nThreads > nInstances )
+    nThreads = nInstances;
+
+  // thread pool: every thread takes the next instance until all are done
+  std::vector<Result>   results( nInstances );
+  std::atomic<uint32_t> next( 0 );
+  std::vector<std::thread> threads;
+  struct timespec t0, t1;
+  clock_gettime( CLOCK_MONOTONIC, &t0 );
+  for( uint32_t t = 0; t < nThreads; t++ )
+  {
+    threads.push_back( std::thread( [ & ]()
+    {
+      uint32_t instance;
+      while( ( instance = next++ ) < nInstances )
+        RunInstance( cfg, instance, results[ instance ] );
+    } ) );
+  }
+  for( size_t t = 0; t < threads.size(); t++ )
+    threads[ t ].join();
+  clock_gettime( CLOCK_MONOTONIC, &t1 );
+  double sec = Seconds( t0, t1 );
+
+  // aggregate
+  Result   sum;
+  uint32_t nFailed = 0;
+  memset( &sum, 0, sizeof( sum ) );
+  for( uint32_t i = 0; i < nInstances; i++ )
+  {
+    const Result & r = results[ i ];
+    if( !r.bOk )
+      nFailed++;
+    sum.nSensors       += r.nSensors;
+    sum.nSymbols       += r.nSymbols;
+    sum.nExFrames      += r.nExFrames;
+    sum.nTextFrames    += r.nTextFrames;
+    sum.nValues        += r.nValues;
+    sum.nDecodedFrames += r.nDecodedFrames;
+    sum.nDecodedValues += r.nDecodedValues;
+    sum.nErrors        += r.nErrors;
+  }
+
+  printf( "%u instances (%u sensors), %u threads, %u s simulated each, seed %u, output %s: %.2f s, %.0fx real time\n",
+          nInstances, sum.nSensors, nThreads, cfg.seconds, cfg.seed, cfg.pPattern ? ( cfg.bRaw ? "raw" : "capture" ) : "none", sec,
+          (double)nInstances * cfg.seconds / sec );
+  printf( "EX frames %u, text frames %u, symbols %llu, values set %u\n", sum.nExFrames, sum.nTextFrames, (unsigned long long)sum.nSymbols, sum.nValues );
+  printf( "aggregate: %.0f EX frames/s, %.0f frames/s, %.2f M symbols/s\n", sum.nExFrames / sec, ( sum.nExFrames + sum.nTextFrames ) / sec, sum.nSymbols / sec / 1e6 );
+  if( cfg.bDecode )
+    printf( "decoded: EX frames %u, values %u, errors %u\n", sum.nDecodedFrames, sum.nDecodedValues, sum.nErrors );
+  if( nFailed )
+    printf( "%u instances failed\n", nFailed );
+
+  return nFailed ? 2 : 0;
+}
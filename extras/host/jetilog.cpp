@@ -0,0 +1,326 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetilog - decode and test the full-rate binary value log (JetiExLog)
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetilog [-v] <file>
+    jetilog -g seconds [-s sensors] [-b bufSize] [-w bytesPerPoll] [-r seed] <file>
+
+    Decode: prints the sensor table of the header and per sensor the number of values,
+    min/max and the records lost (ring buffer full), -v prints every value.
+    -g  generate a log: JetiExProtocol on a virtual clock, random sensor table (all data
+        types) with periods of 1..100 ms, the values are logged with SetLog() and a file sink.
+        The file is decoded again and compared with the values set.
+    -b  ring buffer size of JetiExLog
+    -w  sink takes at most bytesPerPoll bytes per DoJetiSend() (slow SD card), 0: all
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetilog jetilog.cpp JetiExLogFile.cpp JetiExDecoder.cpp JetiExSim.cpp
+        ../../src/JetiExLog.cpp ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+#include <vector>
+#include "JetiExLogFile.h"
+#include "JetiExSim.h"
+
+// sink with limited throughput
+///////////////////////////////
+class SlowSink : public JetiExFileLogSink
+{
+public:
+  SlowSink( FILE * fp, uint16_t maxPerPoll ) : JetiExFileLogSink( fp ), m_maxPerPoll( maxPerPoll ), m_nLeft( 0xFFFF ) {}  // header is written at once
+
+  virtual uint16_t Write( const uint8_t * pData, uint16_t n )
+  {
+    if( m_maxPerPoll && n > m_nLeft )
+      n = m_nLeft;
+    n = JetiExFileLogSink::Write( pData, n );
+    m_nLeft -= m_maxPerPoll ? n : 0;
+    return n;
+  }
+  void NextPoll() { m_nLeft = m_maxPerPoll; }
+  void Unlimited() { m_maxPerPoll = 0; }
+
+protected:
+  uint16_t m_maxPerPoll;
+  uint16_t m_nLeft;
+};
+
+static void PrintValue( const JetiExValue & v )
+{
+  if( v.dataType == JetiSensor::TYPE_DT )
+    printf( v.bDate ? "%02u.%02u.%04u" : "%02u:%02u:%02u", v.dt[ 0 ], v.dt[ 1 ], v.bDate ? 2000 + v.dt[ 2 ] : v.dt[ 2 ] );
+  else if( v.dataType == JetiSensor::TYPE_GPS )
+    printf( "%.5f %s", v.gps, v.bLongitude ? "lon" : "lat" );
+  else
+    printf( "%.*f", v.precision, JetiExDecoder::ToDouble( v ) );
+}
+
+static int Decode( const char * path, bool bVerbose )
+{
+  JetiExLogReader reader;
+  if( !reader.Open( path ) )
+  {
+    fprintf( stderr, "%s: no value log\n", path );
+    return 1;
+  }
+
+  const std::vector<JetiExLogSensor> & sensors = reader.GetSensors();
+  std::vector<uint32_t> nValues( sensors.size(), 0 );
+  std::vector<double>   vMin( sensors.size(), 0 ), vMax( sensors.size(), 0 );
+  uint32_t        nRecords = 0, nGap = 0;
+  uint64_t        tiMs     = 0;
+  JetiExLogRecord rec;
+  while( reader.Next( rec ) )
+  {
+    JetiExValue v = reader.ToValue( rec );
+    double      d = JetiExDecoder::ToDouble( v );
+    if( bVerbose )
+    {
+      if( rec.nGap )
+        printf( "%10.3f --- %u values lost\n", rec.tiMs / 1000.0, rec.nGap );
+      printf( "%10.3f %04X %3u %-20s ", rec.tiMs / 1000.0, v.devId, v.id, sensors[ rec.slot ].text );
+      PrintValue( v );
+      printf( " %s\n", sensors[ rec.slot ].unit );
+    }
+    if( nValues[ rec.slot ]++ == 0 || d < vMin[ rec.slot ] )
+      vMin[ rec.slot ] = d;
+    if( nValues[ rec.slot ] == 1 || d > vMax[ rec.slot ] )
+      vMax[ rec.slot ] = d;
+    nRecords++;
+    nGap += rec.nGap;
+    tiMs  = rec.tiMs;
+  }
+
+  printf( "%s: start at millis() %u, %.3f s, values %u, lost %u, format errors %u\n", path, reader.GetStartMillis(), tiMs / 1000.0, nRecords, nGap, reader.GetErrors() );
+  printf( "\n  dev   id type  label                    values   values/s          min          max\n" );
+  for( size_t i = 0; i < sensors.size(); i++ )
+  {
+    char label[ 48 ];
+    snprintf( label, sizeof( label ), "%s [%s]", sensors[ i ].text, sensors[ i ].unit );
+    printf( "  %04X %3u %-4s  %-22s %8u %10.1f %12.3f %12.3f\n", sensors[ i ].devId, sensors[ i ].id, JetiExDecoder::TypeName( sensors[ i ].dataType ), label,
+            nValues[ i ], tiMs ? nValues[ i ] * 1000.0 / tiMs : 0.0, vMin[ i ], vMax[ i ] );
+  }
+  return reader.GetErrors() ? 2 : 0;
+}
+
+// values set in generate mode
+typedef struct
+{
+  uint64_t tiMs;
+  uint16_t slot;
+  int32_t  value;       // SetSensorValue()
+  uint8_t  dt[ 3 ];     // SetSensorValueDate()/Time()
+  double   gps;         // SetSensorValueGPS()
+}
+Expected;
+
+static int Generate( const char * path, uint32_t seconds, uint32_t nSensors, uint16_t bufSize, uint16_t bytesPerPoll, uint32_t seed )
+{
+  static const uint8_t types[] = { JetiSensor::TYPE_6b, JetiSensor::TYPE_14b, JetiSensor::TYPE_22b, JetiSensor::TYPE_DT, JetiSensor::TYPE_30b, JetiSensor::TYPE_GPS };
+  std::mt19937 rng( seed );
+
+  // sensor table, id = slot + 1
+  std::vector<JetiSensorConst> sensors( nSensors + 1 );
+  std::vector<uint32_t>        periodMs( nSensors );
+  memset( &sensors[ 0 ], 0, sensors.size() * sizeof( JetiSensorConst ) );
+  for( uint32_t i = 0; i < nSensors; i++ )
+  {
+    JetiSensorConst & s = sensors[ i ];
+    s.id        = i + 1;
+    s.dataType  = types[ i % sizeof( types ) ];
+    s.precision = ( s.dataType == JetiSensor::TYPE_DT || s.dataType == JetiSensor::TYPE_GPS ) ? 0 : rng() % 3;
+    snprintf( s.text, sizeof( s.text ), "Value %u", s.id );
+    snprintf( s.unit, sizeof( s.unit ), "u%u", s.id );
+    periodMs[ i ] = 1 + rng() % 100;
+  }
+
+  FILE * fp = fopen( path, "wb" );
+  if( fp == 0 )
+  {
+    perror( path );
+    return 1;
+  }
+
+  JetiExVirtualClock clock( 1000000 );
+  JetiExClock::SetClock( &clock );
+
+  std::vector<Expected> expected;
+  JetiExLog::Stats      ls;
+  {
+    SlowSink        sink( fp, bytesPerPoll );
+    JetiExLog       log( &sink, bufSize );
+    JetiExUartModel uart( 0 );
+    JetiExProtocol  jetiEx;
+    jetiEx.Start( "Logger", &sensors[ 0 ], &uart );
+    if( !jetiEx.SetLog( &log ) )
+    {
+      fprintf( stderr, "SetLog() failed\n" );
+      return 1;
+    }
+
+    uint64_t tiStart = clock.Micros() / 1000;
+    std::vector<uint64_t> tiNext( nSensors, tiStart );
+    std::vector<int32_t>  values( nSensors, 0 );
+    uint64_t tiEnd = clock.Micros() + (uint64_t)seconds * 1000000;
+    while( clock.Micros() < tiEnd )
+    {
+      uint64_t tiMs = clock.Micros() / 1000;
+      for( uint32_t i = 0; i < nSensors; i++ )
+      {
+        if( tiMs < tiNext[ i ] )
+          continue;
+        tiNext[ i ] += periodMs[ i ];
+
+        Expected e;
+        memset( &e, 0, sizeof( e ) );
+        e.tiMs = tiMs - tiStart;
+        e.slot = i;
+        switch( sensors[ i ].dataType )
+        {
+        case JetiSensor::TYPE_DT:
+          e.dt[ 0 ] = rng() % 24; e.dt[ 1 ] = rng() % 60; e.dt[ 2 ] = rng() % 60;
+          jetiEx.SetSensorValueTime( i + 1, e.dt[ 0 ], e.dt[ 1 ], e.dt[ 2 ] );
+          break;
+        case JetiSensor::TYPE_GPS:
+          e.gps = ( (int32_t)( rng() % 360000000 ) - 180000000 ) / 1e6;
+          jetiEx.SetSensorValueGPS( i + 1, true, (float)e.gps );
+          break;
+        default:
+          values[ i ] += (int32_t)( rng() % 201 ) - 100;       // slowly changing sensor
+          e.value = values[ i ];
+          jetiEx.SetSensorValue( i + 1, e.value );
+          break;
+        }
+        expected.push_back( e );
+      }
+
+      sink.NextPoll();
+      jetiEx.DoJetiSend();
+      uart.Update( clock.Micros() );
+      clock.Advance( 1000 );
+    }
+    sink.Unlimited();
+    log.Flush();
+    ls = log.GetStats();
+  }
+  JetiExClock::SetClock( 0 );
+  fclose( fp );
+
+  // decode and compare
+  JetiExLogReader reader;
+  if( !reader.Open( path ) )
+  {
+    fprintf( stderr, "%s: no value log\n", path );
+    return 1;
+  }
+  JetiExLogRecord rec;
+  size_t   pos = 0;
+  uint32_t nDecoded = 0, nLost = 0, nWrong = 0;
+  while( reader.Next( rec ) )
+  {
+    nLost += rec.nGap;
+    pos   += rec.nGap;
+    if( pos >= expected.size() )
+    {
+      nWrong++;
+      break;
+    }
+    const Expected & e = expected[ pos++ ];
+    JetiExValue      v = reader.ToValue( rec );
+    bool bOk = rec.slot == e.slot && rec.tiMs == e.tiMs;
+    if( v.dataType == JetiSensor::TYPE_DT )
+      bOk = bOk && !v.bDate && memcmp( v.dt, e.dt, sizeof( e.dt ) ) == 0;
+    else if( v.dataType == JetiSensor::TYPE_GPS )
+      bOk = bOk && v.bLongitude && fabs( v.gps - e.gps ) < 1e-4;
+    else
+      bOk = bOk && rec.value == e.value;
+    if( !bOk )
+      nWrong++;
+    nDecoded++;
+  }
+  bool bOk = nWrong == 0 && reader.GetErrors() == 0 && nDecoded == ls.nRecords && nDecoded + ls.nDropped == expected.size() && nLost <= ls.nDropped; // no gap record after the last drops
+
+  printf( "%u s, %u sensors, ring buffer %u, sink %u bytes per poll: values set %u, logged %u, dropped %u, ring buffer max %u\n", seconds, nSensors, bufSize, bytesPerPoll,
+          (unsigned)expected.size(), ls.nRecords, ls.nDropped, ls.highWater );
+  printf( "log %u bytes (%.2f bytes per value, %.0f bytes/s), decoded %u, lost %u, wrong %u %s\n", ls.nBytes, ls.nRecords ? (double)ls.nBytes / ls.nRecords : 0.0,
+          ls.nBytes / (double)seconds, nDecoded, nLost, nWrong, bOk ? "ok" : "MISMATCH" );
+  return bOk ? 0 : 2;
+}
+
+int main( int argc, char ** argv )
+{
+  const char * pPath    = 0;
+  bool         bVerbose = false;
+  uint32_t     seconds  = 0;
+  uint32_t     nSensors = 12;
+  uint32_t     bufSize  = 256;
+  uint32_t     perPoll  = 0;
+  uint32_t     seed     = 1;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-v" ) == 0 )
+      bVerbose = true;
+    else if( strcmp( argv[ i ], "-g" ) == 0 && i + 1 < argc )
+      seconds = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-s" ) == 0 && i + 1 < argc )
+      nSensors = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-b" ) == 0 && i + 1 < argc )
+      bufSize = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-w" ) == 0 && i + 1 < argc )
+      perPoll = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-r" ) == 0 && i + 1 < argc )
+      seed = atol( argv[ ++i ] );
+    else if( argv[ i ][ 0 ] != '-' && pPath == 0 )
+      pPath = argv[ i ];
+    else
+    {
+      pPath = 0;
+      break;
+    }
+  }
+  if( pPath == 0 )
+  {
+    fprintf( stderr, "usage: jetilog [-v] <file>\n       jetilog -g seconds [-s sensors] [-b bufSize] [-w bytesPerPoll] [-r seed] <file>\n" );
+    return 1;
+  }
+  if( nSensors < 1 || nSensors > 31 || bufSize > 0xFFFF || perPoll > 0xFFFF )
+  {
+    fprintf( stderr, "sensors 1..31, bufSize and bytesPerPoll < 65536\n" );
+    return 1;
+  }
+
+  return seconds ? Generate( pPath, seconds, nSensors, bufSize, perPoll, seed ) : Decode( pPath, bVerbose );
+}
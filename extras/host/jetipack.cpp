@@ -0,0 +1,417 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetipack - generate a packed sensor table with a shared label string pool
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetipack [-n name] [-o out.h] <sketch.ino|source.cpp>
+
+    Reads the first JETISENSOR_CONST table of the source file and writes a
+    JETISENSOR_PACKED table (6 bytes per sensor) and a deduplicated PROGMEM string pool.
+    Descriptions and units are truncated like JetiSensor does (19 characters in total),
+    labels which are part of another label share its bytes.
+    -n  name of generated tables: <name>Packed[] and <name>Pool[] (default: name of source table)
+    -o  output file (default: stdout)
+
+    Use it in your sketch:
+      #include "sensors_packed.h"
+      jetiEx.Start( "ECU", sensorsPacked, sensorsPool );
+
+  Build (see HostReadme.txt):
+    g++ -O2 -o jetipack jetipack.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// limits of JetiSensorConst and JetiSensor
+enum { MAX_LABEL = 19, MAX_TEXT = 19, MAX_UNIT = 7, SIZEOF_CONST = 30, SIZEOF_PACKED = 6 };
+
+typedef struct
+{
+  std::string id;         // expressions are copied as they are
+  std::string dataType;
+  std::string precision;
+  std::string text;
+  std::string unit;
+  size_t      offset;     // in pool
+}
+Entry;
+
+// read file and remove comments, string and character literals are kept
+/////////////////////////////////////////////////////////////////////////
+static bool ReadSource( const char * pPath, std::string & src )
+{
+  FILE * fp = fopen( pPath, "rb" );
+  if( fp == 0 )
+    return false;
+  std::string raw;
+  char        buf[ 4096 ];
+  size_t      n;
+  while( ( n = fread( buf, 1, sizeof( buf ), fp ) ) > 0 )
+    raw.append( buf, n );
+  fclose( fp );
+
+  for( size_t i = 0; i < raw.size(); i++ )
+  {
+    char c = raw[ i ];
+    if( c == '/' && i + 1 < raw.size() && raw[ i + 1 ] == '/' )
+    {
+      while( i < raw.size() && raw[ i ] != '\n' )
+        i++;
+      src += '\n';
+    }
+    else if( c == '/' && i + 1 < raw.size() && raw[ i + 1 ] == '*' )
+    {
+      size_t end = raw.find( "*/", i + 2 );
+      i = end == std::string::npos ? raw.size() : end + 1;
+      src += ' ';
+    }
+    else if( c == '"' || c == '\'' )
+    {
+      src += c;
+      for( i++; i < raw.size() && raw[ i ] != c; i++ )
+      {
+        if( raw[ i ] == '\\' && i + 1 < raw.size() )
+          src += raw[ i++ ];
+        src += raw[ i ];
+      }
+      src += c;
+    }
+    else
+      src += c;
+  }
+  return true;
+}
+
+static std::string Trim( const std::string & s )
+{
+  size_t b = s.find_first_not_of( " \t\r\n" );
+  size_t e = s.find_last_not_of( " \t\r\n" );
+  return b == std::string::npos ? std::string() : s.substr( b, e - b + 1 );
+}
+
+// unescape one or more adjacent C string literals, false: no string literal
+static bool Unescape( const std::string & field, std::string & out )
+{
+  std::string s = Trim( field );
+  size_t      i = 0;
+  out.clear();
+  if( s.empty() || s[ 0 ] != '"' )
+    return false;
+  while( i < s.size() )
+  {
+    if( s[ i ] != '"' )
+    {
+      if( strchr( " \t\r\n", s[ i ] ) == 0 )
+        return false;
+      i++;
+      continue;
+    }
+    for( i++; i < s.size() && s[ i ] != '"'; i++ )
+    {
+      if( s[ i ] != '\\' || i + 1 >= s.size() )
+      {
+        out += s[ i ];
+        continue;
+      }
+      char c = s[ ++i ];
+      if( c == 'x' )
+      {
+        int v = 0;
+        while( i + 1 < s.size() && isxdigit( (unsigned char)s[ i + 1 ] ) )
+        {
+          char h = s[ ++i ];
+          v = v * 16 + ( isdigit( (unsigned char)h ) ? h - '0' : tolower( h ) - 'a' + 10 );
+        }
+        out += (char)v;
+      }
+      else if( c >= '0' && c <= '7' )
+      {
+        int v = c - '0';
+        for( int k = 0; k < 2 && i + 1 < s.size() && s[ i + 1 ] >= '0' && s[ i + 1 ] <= '7'; k++ )
+          v = v * 8 + s[ ++i ] - '0';
+        out += (char)v;
+      }
+      else
+      {
+        const char * pFrom = "ntrab\"'\\?";
+        const char * pTo   = "\n\t\r\a\b\"'\\?";
+        const char * p     = strchr( pFrom, c );
+        out += p ? pTo[ p - pFrom ] : c;
+      }
+    }
+    i++;
+  }
+  return true;
+}
+
+// split "{ a, b, c }" at top level commas
+static void Split( const std::string & s, std::vector<std::string> & fields )
+{
+  int         depth = 0;
+  std::string cur;
+  fields.clear();
+  for( size_t i = 0; i < s.size(); i++ )
+  {
+    char c = s[ i ];
+    if( c == '"' || c == '\'' )
+    {
+      size_t j = i;
+      for( j++; j < s.size() && s[ j ] != c; j++ )
+        if( s[ j ] == '\\' )
+          j++;
+      cur.append( s, i, j - i + 1 );
+      i = j;
+      continue;
+    }
+    if( c == '(' || c == '{' || c == '[' )
+      depth++;
+    else if( c == ')' || c == '}' || c == ']' )
+      depth--;
+    if( c == ',' && depth == 0 )
+    {
+      fields.push_back( Trim( cur ) );
+      cur.clear();
+    }
+    else
+      cur += c;
+  }
+  if( !Trim( cur ).empty() )
+    fields.push_back( Trim( cur ) );
+}
+
+// find table "JETISENSOR_CONST name[] ... = { {...}, ... }" and parse its entries
+/////////////////////////////////////////////////////////////////////////////////
+static bool ParseTable( const std::string & src, std::string & name, std::vector<Entry> & entries )
+{
+  size_t pos = src.find( "JETISENSOR_CONST" );
+  while( pos != std::string::npos )
+  {
+    size_t p = pos + strlen( "JETISENSOR_CONST" );
+    while( p < src.size() && isspace( (unsigned char)src[ p ] ) )
+      p++;
+    size_t b = p;
+    while( p < src.size() && ( isalnum( (unsigned char)src[ p ] ) || src[ p ] == '_' ) )
+      p++;
+    name = src.substr( b, p - b );
+    size_t eq = src.find_first_of( "=;", p );
+    if( !name.empty() && eq != std::string::npos && src[ eq ] == '=' && src.find( '[', p ) < eq )
+      break;
+    pos = src.find( "JETISENSOR_CONST", p );
+  }
+  if( pos == std::string::npos )
+    return false;
+
+  // entries
+  size_t p = src.find( '{', pos ) + 1;
+  for( ;; )
+  {
+    p = src.find_first_of( "{}", p );
+    if( p == std::string::npos || src[ p ] == '}' )
+      break;
+    size_t e = p + 1;
+    for( int depth = 1; e < src.size() && depth > 0; e++ )
+    {
+      if( src[ e ] == '"' || src[ e ] == '\'' )
+      {
+        char q = src[ e ];
+        for( e++; e < src.size() && src[ e ] != q; e++ )
+          if( src[ e ] == '\\' )
+            e++;
+      }
+      else if( src[ e ] == '{' )
+        depth++;
+      else if( src[ e ] == '}' )
+        depth--;
+    }
+    std::vector<std::string> fields;
+    Split( src.substr( p + 1, e - p - 2 ), fields );
+    p = e;
+
+    if( fields.empty() || fields[ 0 ] == "0" )  // end of table
+      break;
+    Entry entry;
+    if( fields.size() < 5 || !Unescape( fields[ 1 ], entry.text ) || !Unescape( fields[ 2 ], entry.unit ) )
+    {
+      fprintf( stderr, "can't parse sensor entry %u (id %s)\n", (unsigned)entries.size() + 1, fields.empty() ? "?" : fields[ 0 ].c_str() );
+      return false;
+    }
+    entry.id        = fields[ 0 ];
+    entry.dataType  = fields[ 3 ];
+    entry.precision = fields[ 4 ];
+    entry.offset    = 0;
+
+    // like JetiSensor: text is limited by '\0', unit by '\0' or field size, both together to 19 characters
+    entry.text = entry.text.substr( 0, strlen( entry.text.c_str() ) );
+    entry.unit = entry.unit.substr( 0, strlen( entry.unit.c_str() ) );
+    if( entry.text.size() > MAX_TEXT || entry.text.size() + std::min( entry.unit.size(), (size_t)MAX_UNIT ) > MAX_LABEL || entry.unit.size() > MAX_UNIT )
+      fprintf( stderr, "warning: label of sensor %s truncated\n", entry.id.c_str() );
+    entry.text = entry.text.substr( 0, MAX_TEXT );
+    entry.unit = entry.unit.substr( 0, std::min( (size_t)MAX_UNIT, MAX_LABEL - entry.text.size() ) );
+    entries.push_back( entry );
+  }
+  return true;
+}
+
+// shared string pool: a label which is contained in the pool is reused,
+// otherwise it is appended with the largest overlap to the end of the pool
+///////////////////////////////////////////////////////////////////////////
+static bool LongerLabel( const Entry * a, const Entry * b )
+{
+  return a->text.size() + a->unit.size() > b->text.size() + b->unit.size();
+}
+
+static std::string BuildPool( std::vector<Entry> & entries )
+{
+  std::vector<Entry*> order;
+  for( size_t i = 0; i < entries.size(); i++ )
+    order.push_back( &entries[ i ] );
+  std::stable_sort( order.begin(), order.end(), LongerLabel );
+
+  std::string pool;
+  for( size_t i = 0; i < order.size(); i++ )
+  {
+    std::string label = order[ i ]->text + order[ i ]->unit;
+    size_t      found = pool.find( label );
+    if( found != std::string::npos )
+    {
+      order[ i ]->offset = found;
+      continue;
+    }
+    size_t overlap = std::min( label.size(), pool.size() );
+    while( overlap > 0 && pool.compare( pool.size() - overlap, overlap, label, 0, overlap ) != 0 )
+      overlap--;
+    order[ i ]->offset = pool.size() - overlap;
+    pool.append( label, overlap, std::string::npos );
+  }
+  return pool;
+}
+
+// C string literal, non printable characters as 3 digit octal escapes
+static std::string Quote( const std::string & s )
+{
+  std::string out = "\"";
+  for( size_t i = 0; i < s.size(); i++ )
+  {
+    unsigned char c = s[ i ];
+    char          buf[ 8 ];
+    if( c == '"' || c == '\\' || c == '?' )
+      out += '\\', out += c;
+    else if( c < 0x20 || c >= 0x7F )
+      snprintf( buf, sizeof( buf ), "\\%03o", c ), out += buf;
+    else
+      out += c;
+  }
+  return out + "\"";
+}
+
+int main( int argc, char ** argv )
+{
+  const char * pIn   = 0;
+  const char * pOut  = 0;
+  std::string  name;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-n" ) == 0 && i + 1 < argc )
+      name = argv[ ++i ];
+    else if( strcmp( argv[ i ], "-o" ) == 0 && i + 1 < argc )
+      pOut = argv[ ++i ];
+    else
+      pIn = argv[ i ];
+  }
+  if( pIn == 0 )
+  {
+    fprintf( stderr, "usage: jetipack [-n name] [-o out.h] <sketch.ino|source.cpp>\n" );
+    return 1;
+  }
+
+  std::string        src, tableName;
+  std::vector<Entry> entries;
+  if( !ReadSource( pIn, src ) )
+  {
+    perror( pIn );
+    return 1;
+  }
+  if( !ParseTable( src, tableName, entries ) || entries.empty() )
+  {
+    fprintf( stderr, "%s: no JETISENSOR_CONST table found\n", pIn );
+    return 1;
+  }
+  if( name.empty() )
+    name = tableName;
+
+  std::string pool = BuildPool( entries );
+  if( pool.size() > 0xFFFF )
+  {
+    fprintf( stderr, "string pool too large\n" );
+    return 1;
+  }
+
+  FILE * fp = pOut ? fopen( pOut, "w" ) : stdout;
+  if( fp == 0 )
+  {
+    perror( pOut );
+    return 1;
+  }
+
+  // header
+  fprintf( fp, "// generated by jetipack from %s, table %s - don't edit\n", pIn, tableName.c_str() );
+  fprintf( fp, "// %u sensors: %u bytes (JetiSensorConst: %u bytes)\n\n", (unsigned)entries.size(),
+           (unsigned)( ( entries.size() + 1 ) * SIZEOF_PACKED + pool.size() + 1 ), (unsigned)( ( entries.size() + 1 ) * SIZEOF_CONST ) );
+
+  // string pool, 64 characters per line
+  fprintf( fp, "const char %sPool[] PROGMEM =\n", name.c_str() );
+  for( size_t i = 0; i < pool.size() || i == 0; i += 64 )
+    fprintf( fp, "  %s%s\n", Quote( pool.substr( i, 64 ) ).c_str(), i + 64 >= pool.size() ? ";" : "" );
+
+  // packed table
+  fprintf( fp, "\nJETISENSOR_PACKED %sPacked[] PROGMEM =\n{\n", name.c_str() );
+  fprintf( fp, "  // id, data type, precision, label length, pool offset\n" );
+  for( size_t i = 0; i < entries.size(); i++ )
+  {
+    const Entry & e = entries[ i ];
+    fprintf( fp, "  { %s, %s, %s, (%u << 3) | %u, %u }, // %s %s\n", e.id.c_str(), e.dataType.c_str(), e.precision.c_str(),
+             (unsigned)e.text.size(), (unsigned)e.unit.size(), (unsigned)e.offset, Quote( e.text ).c_str(), Quote( e.unit ).c_str() );
+  }
+  fprintf( fp, "  { 0 } // end of array\n};\n" );
+
+  if( fp != stdout )
+    fclose( fp );
+
+  fprintf( stderr, "%u sensors, labels %u -> %u bytes, table %u -> %u bytes\n", (unsigned)entries.size(),
+           (unsigned)( entries.size() * ( SIZEOF_CONST - 3 ) ), (unsigned)pool.size() + 1,
+           (unsigned)( ( entries.size() + 1 ) * SIZEOF_CONST ), (unsigned)( ( entries.size() + 1 ) * SIZEOF_PACKED + pool.size() + 1 ) );
+  return 0;
+}
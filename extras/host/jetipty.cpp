@@ -0,0 +1,233 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetipty - loopback test of the termios serial port (JetiExTermios.h)
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetipty [-t seconds] [senderTty receiverTty]
+
+    Runs JetiExProtocol with JetiExTermiosSerial and decodes the output again with
+    JetiExTermiosReader and JetiExDecoder. Jetibox keys are sent back once a second.
+    Without ttys a pseudo terminal is used on a virtual clock: a pty carries no parity bit,
+    so the sender port (JetiExPtySerial) writes the symbols like a receiving UART with 
+    space parity and PARMRK would deliver them. 
+    With two ttys (i.e. two USB-UARTs, TX of the first connected to RX of the second and 
+    vice versa) the test runs in real time on real hardware.
+    Exit code 0: no errors.
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetipty jetipty.cpp JetiExTermios.cpp JetiExDecoder.cpp
+        ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "JetiExProtocol.h"
+#include "JetiExDecoder.h"
+#include "JetiExTermios.h"
+
+// pty: parity marking in the sender
+////////////////////////////////////
+class JetiExPtySerial : public JetiExTermiosSerial
+{
+public:
+  JetiExPtySerial( const char * pDevice ) : JetiExTermiosSerial( pDevice ) {}
+
+protected:
+  virtual bool Write( const uint8_t * pData, size_t n )
+  {
+    uint8_t buf[ 3 * sizeof( m_run ) ];
+    size_t  len = 0;
+    for( size_t i = 0; i < n; i++ )
+    {
+      if( m_bLineMark )
+      {
+        buf[ len++ ] = 0xFF;
+        buf[ len++ ] = 0x00;
+      }
+      else if( pData[ i ] == 0xFF )
+        buf[ len++ ] = 0xFF;
+      buf[ len++ ] = pData[ i ];
+    }
+    return JetiExTermiosSerial::Write( buf, len );
+  }
+};
+
+// check decoded values
+///////////////////////
+class Checker : public JetiExDecoderSink
+{
+public:
+  Checker() : m_nValues( 0 ), m_nBad( 0 ) {}
+
+  virtual void OnValue( const JetiExValue & v, uint64_t tiUs )
+  {
+    m_nValues++;
+    if( v.value / 1000 != v.id )                    // values are id * 1000 + counter
+      m_nBad++;
+  }
+
+  uint32_t m_nValues;
+  uint32_t m_nBad;
+};
+
+enum { N_SENSORS = 8 };
+
+int main( int argc, char ** argv )
+{
+  uint32_t     seconds = 30;
+  const char * pTx     = 0;
+  const char * pRx     = 0;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-t" ) == 0 && i + 1 < argc )
+      seconds = atoi( argv[ ++i ] );
+    else if( argv[ i ][ 0 ] == '-' )
+    {
+      fprintf( stderr, "usage: jetipty [-t seconds] [senderTty receiverTty]\n" );
+      return 1;
+    }
+    else if( pTx == 0 )
+      pTx = argv[ i ];
+    else
+      pRx = argv[ i ];
+  }
+  bool bPty = pTx == 0;
+  if( !bPty && pRx == 0 )
+  {
+    fprintf( stderr, "receiver tty missing\n" );
+    return 1;
+  }
+
+  // receiver side
+  JetiExTermiosReader reader;
+  int                 master = -1;
+  if( bPty )
+  {
+    master = posix_openpt( O_RDWR | O_NOCTTY | O_NONBLOCK );
+    if( master < 0 || grantpt( master ) != 0 || unlockpt( master ) != 0 )
+    {
+      perror( "pty" );
+      return 1;
+    }
+    pTx = ptsname( master );
+    reader.Attach( master );
+  }
+  else if( !reader.Open( pRx ) )
+  {
+    perror( pRx );
+    return 1;
+  }
+
+  // sensor side
+  JetiExVirtualClock clock;
+  if( bPty )
+    JetiExClock::SetClock( &clock );
+
+  JetiSensorConst sensors[ N_SENSORS + 1 ];
+  memset( sensors, 0, sizeof( sensors ) );
+  for( int i = 0; i < N_SENSORS; i++ )
+  {
+    sensors[ i ].id       = i + 1;
+    sensors[ i ].dataType = JetiSensor::TYPE_22b;
+    snprintf( sensors[ i ].text, sizeof( sensors[ i ].text ), "Sensor %d", i + 1 );
+    strcpy( sensors[ i ].unit, "V" );
+  }
+
+  JetiExTermiosSerial * pPort = bPty ? new JetiExPtySerial( pTx ) : new JetiExTermiosSerial( pTx );
+  Checker               checker;
+  JetiExDecoder         decoder( &checker );
+  JetiExProtocol        jetiEx;
+  jetiEx.Start( "Loopback", sensors, pPort );
+  if( !pPort->IsOpen() )
+    return 1;
+  jetiEx.SetJetiboxText( JetiExProtocol::LINE1, "termios" );
+  jetiEx.SetJetiboxText( JetiExProtocol::LINE2, "loopback" );
+
+  uint64_t tiStart = micros(), tiNextValue = tiStart, tiNextKey = tiStart + 1000000;
+  uint64_t tiEnd   = tiStart + (uint64_t)seconds * 1000000;
+  uint32_t counter = 0, nKeysSent = 0, nKeys = 0;
+  uint16_t symbols[ 256 ];
+  int      n;
+  while( micros() < tiEnd )
+  {
+    if( micros() >= tiNextValue )
+    {
+      counter = ( counter + 1 ) % 1000;
+      for( int id = 1; id <= N_SENSORS; id++ )
+        jetiEx.SetSensorValue( id, id * 1000 + counter );
+      tiNextValue += 100000;
+    }
+    if( micros() >= tiNextKey && reader.SendKey( 0xB0 ) ) // down
+    {
+      nKeysSent++;
+      tiNextKey += 1000000;
+    }
+    while( jetiEx.GetJetiboxKey() )
+      nKeys++;
+    jetiEx.DoJetiSend();
+
+    while( ( n = reader.Read( symbols, 256 ) ) > 0 )
+      for( int i = 0; i < n; i++ )
+        decoder.Put( symbols[ i ], micros() );
+
+    if( bPty )
+      clock.Advance( 1000 );
+    else
+      usleep( 1000 );
+  }
+
+  // receive the rest
+  pPort->Flush();
+  for( int i = 0; i < 200; i++ )
+  {
+    while( ( n = reader.Read( symbols, 256 ) ) > 0 )
+      for( int j = 0; j < n; j++ )
+        decoder.Put( symbols[ j ], micros() );
+    if( !bPty )
+      usleep( 1000 );
+  }
+
+  const JetiExTermiosSerial::Stats & ps = pPort->GetStats();
+  const JetiExDecoder::Stats &       ds = decoder.GetStats();
+  printf( "%s: %u s, symbols written %u in %u write() calls (%.1f per call), parity switches %u, write errors %u\n",
+          bPty ? "pty" : pTx, seconds, ps.nSymbols, ps.nWrites, ps.nWrites ? (double)ps.nSymbols / ps.nWrites : 0.0, ps.nSwitches, ps.nErrors );
+  printf( "received symbols %llu, EX frames %u, values %u (wrong %u), text frames %u, errors %u (crc %u), keys %u/%u\n",
+          (unsigned long long)ds.nSymbols, ds.nExFrames, checker.m_nValues, checker.m_nBad, ds.nTextFrames, ds.nErrors, ds.nCrcErrors, nKeys, nKeysSent );
+
+  bool bOk = ps.nErrors == 0 && ds.nErrors == 0 && checker.m_nBad == 0 && ds.nExFrames > 0 && nKeys == nKeysSent;
+  delete pPort;
+  if( master >= 0 )
+    close( master );
+  JetiExClock::SetClock( 0 );
+  return bOk ? 0 : 2;
+}
@@ -0,0 +1,265 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetireplay - replay a capture through the current library version and compare the output
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetireplay [-s session] [-o out.cap] <in.cap>
+
+    The sensor table, device id, values, Jetibox texts, alarms and exits are reconstructed
+    from the recorded EX stream. A JetiExProtocol instance runs on a virtual clock
+    (faster than real time), keys are fed back to GetJetiboxKey() with original timing.
+    The new wire output is compared symbol by symbol with the recording and optionally
+    written to out.cap. Exit code 0: identical, 2: different.
+    Values set to -1 ("invalid") are never transmitted and therefore can't be replayed.
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetireplay jetireplay.cpp JetiExCapture.cpp JetiExDecoder.cpp
+        ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "JetiExProtocol.h"
+#include "JetiExCapture.h"
+#include "JetiExDecoder.h"
+
+// recorded application activity
+enum { EVT_VALUE, EVT_TEXT, EVT_ALARM, EVT_EXIT };
+typedef struct
+{
+  uint8_t  type;
+  uint64_t tiUs;
+  uint8_t  id;
+  int32_t  value;
+  char     text[ 32 ];
+}
+Event;
+
+// decoded label to sensor table field, truncated and always terminated
+static void CopyLabel( char * pDst, size_t size, const char * pSrc )
+{
+  size_t n = strnlen( pSrc, size - 1 );
+  memcpy( pDst, pSrc, n );
+  pDst[ n ] = '\0';
+}
+
+// reconstruct sensor table and application events from the recorded stream
+///////////////////////////////////////////////////////////////////////////
+class Collector : public JetiExDecoderSink
+{
+public:
+  Collector() : m_devId( 0 ), m_bDevice( false ) { m_name[ 0 ] = '\0'; memset( m_lastText, 0, sizeof( m_lastText ) ); memset( m_bValue, 0, sizeof( m_bValue ) ); }
+
+  virtual void OnDictionary( const JetiExDictEntry & e, uint64_t tiUs )
+  {
+    if( !Device( e.devId ) )
+      return;
+    if( e.id == 0 )
+    {
+      CopyLabel( m_name, sizeof( m_name ), e.text );
+      return;
+    }
+    for( size_t i = 0; i < m_sensors.size(); i++ )
+      if( m_sensors[ i ].id == e.id )
+        return;
+
+    JetiSensorConst s;
+    memset( &s, 0, sizeof( s ) );
+    s.id = e.id;
+    CopyLabel( s.text, sizeof( s.text ), e.text );
+    CopyLabel( s.unit, sizeof( s.unit ), e.unit );
+    m_sensors.push_back( s );
+  }
+
+  virtual void OnValue( const JetiExValue & v, uint64_t tiUs )
+  {
+    if( !Device( v.devId ) )
+      return;
+    for( size_t i = 0; i < m_sensors.size(); i++ )
+    {
+      if( m_sensors[ i ].id == v.id )
+      {
+        m_sensors[ i ].dataType  = v.dataType;
+        m_sensors[ i ].precision = v.precision;
+      }
+    }
+    if( m_bValue[ v.id ] && m_lastValue[ v.id ] == v.value )
+      return;
+    m_bValue[ v.id ]    = true;
+    m_lastValue[ v.id ] = v.value;
+    Add( EVT_VALUE, tiUs, v.id, v.value, 0 );
+  }
+
+  virtual void OnText( const char * text, uint64_t tiUs )
+  {
+    if( memcmp( text, m_lastText, 32 ) == 0 )
+      return;
+    memcpy( m_lastText, text, 32 );
+    Add( EVT_TEXT, tiUs, 0, 0, text );
+  }
+
+  virtual void OnAlarm( char code, bool bSound, uint64_t tiUs ) { Add( EVT_ALARM, tiUs, 0, bSound ? toupper( code ) : tolower( code ), 0 ); }
+  virtual void OnExit( uint64_t tiUs )                           { Add( EVT_EXIT, tiUs, 0, 0, 0 ); }
+
+  void Add( uint8_t type, uint64_t tiUs, uint8_t id, int32_t value, const char * text )
+  {
+    Event e;
+    e.type  = type;
+    e.tiUs  = tiUs > 1000 ? tiUs - 1000 : 0;  // the application has set it before it was sent
+    e.id    = id;
+    e.value = value;
+    if( text )
+      memcpy( e.text, text, 32 );
+    m_events.push_back( e );
+  }
+
+  bool Device( uint16_t devId )                // first device only
+  {
+    if( !m_bDevice )
+    {
+      m_devId   = devId;
+      m_bDevice = true;
+    }
+    return devId == m_devId;
+  }
+
+  std::vector<JetiSensorConst> m_sensors;
+  std::vector<Event>           m_events;
+  char                         m_name[ 20 ];
+  uint16_t                     m_devId;
+  bool                         m_bDevice;
+  char                         m_lastText[ 32 ];
+  bool                         m_bValue[ 256 ];
+  int32_t                      m_lastValue[ 256 ];
+};
+
+int main( int argc, char ** argv )
+{
+  const char * pIn      = 0;
+  const char * pOut     = 0;
+  uint32_t     session  = 0;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-o" ) == 0 && i + 1 < argc )
+      pOut = argv[ ++i ];
+    else if( strcmp( argv[ i ], "-s" ) == 0 && i + 1 < argc )
+      session = atoi( argv[ ++i ] );
+    else
+      pIn = argv[ i ];
+  }
+  if( pIn == 0 )
+  {
+    fprintf( stderr, "usage: jetireplay [-s session] [-o out.cap] <in.cap>\n" );
+    return 1;
+  }
+
+  // 1st pass: decode recording
+  JetiExCaptureReader reader;
+  if( !reader.Open( pIn ) )
+  {
+    fprintf( stderr, "%s: no capture file\n", pIn );
+    return 1;
+  }
+
+  Collector           collector;
+  JetiExDecoder       decoder( &collector );
+  JetiExCaptureRecord rec;
+  uint64_t            tiEnd = 0;
+  while( reader.Next( rec ) )
+  {
+    if( rec.session != session || rec.kind > JetiExCaptureWriter::REC_TX9 )
+      continue;
+    decoder.Put( rec.data | ( rec.kind == JetiExCaptureWriter::REC_TX9 ? 0x100 : 0 ), rec.tiUs );
+    tiEnd = rec.tiUs;
+  }
+  reader.Close();
+
+  printf( "session %u: device %04X \"%s\", %u sensors, %u events, %.1f s\n", session, collector.m_devId, collector.m_name,
+          (unsigned)collector.m_sensors.size(), (unsigned)collector.m_events.size(), tiEnd / 1e6 );
+
+  // 2nd pass: run current library version on recorded input
+  JetiExVirtualClock clock;
+  JetiExClock::SetClock( &clock );
+
+  std::vector<JetiSensorConst> sensors = collector.m_sensors;
+  JetiSensorConst              endMark;
+  memset( &endMark, 0, sizeof( endMark ) );
+  sensors.push_back( endMark );
+
+  JetiExReplaySerial replay( pIn, session, pOut );
+  if( !replay.IsOpen() )
+  {
+    fprintf( stderr, "%s: can't open\n", pIn );
+    return 1;
+  }
+
+  JetiExProtocol jetiEx;
+  jetiEx.SetDeviceId( collector.m_devId & 0xFF, collector.m_devId >> 8 );
+  jetiEx.Start( collector.m_name, sensors.size() > 1 ? &sensors[ 0 ] : 0, &replay );
+
+  size_t evt = 0;
+  while( clock.Micros() <= tiEnd )
+  {
+    for( ; evt < collector.m_events.size() && collector.m_events[ evt ].tiUs <= clock.Micros(); evt++ )
+    {
+      const Event & e = collector.m_events[ evt ];
+      char          line[ 17 ];
+      switch( e.type )
+      {
+      case EVT_VALUE: jetiEx.SetSensorValue( e.id, e.value ); break;
+      case EVT_ALARM: jetiEx.SetJetiAlarm( (char)e.value ); break;
+      case EVT_EXIT:  jetiEx.SetJetiboxExit(); break;
+      case EVT_TEXT:
+        memcpy( line, e.text, 16 );      line[ 16 ] = '\0';
+        jetiEx.SetJetiboxText( JetiExProtocol::LINE1, line );
+        memcpy( line, e.text + 16, 16 ); line[ 16 ] = '\0';
+        jetiEx.SetJetiboxText( JetiExProtocol::LINE2, line );
+        break;
+      }
+    }
+
+    while( jetiEx.GetJetiboxKey() )
+      ;
+    jetiEx.DoJetiSend();
+    clock.Advance( 1000 );
+  }
+
+  const JetiExReplaySerial::Stats & s         = replay.GetStats();
+  uint32_t                          remaining = replay.GetRemaining();
+  printf( "symbols sent: %u, compared: %u, different: %u, additional: %u, missing: %u, keys: %u\n",
+          s.nSent, s.nCompared, s.nMismatch, s.nMissing, remaining, s.nKeys );
+  if( s.firstMismatch >= 0 )
+    printf( "first difference at symbol %lld (%.3f s)\n", (long long)s.firstMismatch, s.tiFirstMismatch / 1e6 );
+
+  JetiExClock::SetClock( 0 );
+  return ( s.nMismatch || s.nMissing || remaining ) ? 2 : 0;
+}
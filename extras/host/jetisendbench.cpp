@@ -0,0 +1,310 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  jetisendbench - DoJetiSend() call duration, time-sliced sending
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Usage:
+    jetisendbench [-t seconds] [-s sensors] [-l loopUs] [-u maxUs] [-n maxUnits] [-c symbolUs]
+
+    Runs the same workload twice on a virtual clock, once as usual and once time-sliced
+    (SetSendBudget( maxUs, maxUnits )), and prints per DoJetiSend() call: symbols sent,
+    modelled duration and measured host CPU time (max, p99, mean).
+    The model charges symbolUs for every Send() (ring buffer write on the target), so the
+    duration the library measures for its health values (GetHealth()) is the modelled one.
+    The time-sliced run must stay within the budget: symbols per call <= maxUnits,
+    modelled duration <= maxUs plus one symbol. Both streams are decoded, every value must
+    be one which was set before, alarms and text frames must arrive, a text frame must not
+    mix old and new text (mix).
+
+  Build (see HostReadme.txt):
+    g++ -O2 -DJETIEX_HOST -I../../src -o jetisendbench jetisendbench.cpp JetiExSim.cpp JetiExDecoder.cpp
+        ../../src/JetiExProtocol.cpp ../../src/JetiExSerial.cpp ../../src/JetiExHost.cpp
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "JetiExProtocol.h"
+#include "JetiExSim.h"
+#include "JetiExDecoder.h"
+
+// UART model which charges CPU time per symbol and counts the symbols of a call
+/////////////////////////////////////////////////////////////////////////////////
+class CostUart : public JetiExUartModel
+{
+public:
+  CostUart( JetiExUartSink * pSink, JetiExVirtualClock * pClock, uint32_t symbolUs )
+    : JetiExUartModel( pSink ), m_pClock( pClock ), m_symbolUs( symbolUs ), m_nCall( 0 ) {}
+
+  virtual void Send( uint8_t data, boolean bit8 )
+  {
+    JetiExUartModel::Send( data, bit8 );
+    m_pClock->Advance( m_symbolUs );
+    m_nCall++;
+  }
+
+  JetiExVirtualClock * m_pClock;
+  uint32_t             m_symbolUs;
+  uint32_t             m_nCall;      // symbols since last reset
+};
+
+// values are the loop counter modulo VALUE_WRAP, a decoded value must have been set
+// within the last MAX_AGE loops
+///////////////////////////////////////////////////////////////////////////////////
+class Receiver : public JetiExUartSink, public JetiExDecoderSink
+{
+public:
+  enum
+  {
+    HEALTH_DEVID = 0x3277,     // AddHealthDevice( ..., 0x77, 0x32 )
+    VALUE_WRAP   = 8000,       // fits TYPE_14b
+    MAX_AGE      = 2000,
+  };
+
+  Receiver() : m_decoder( this ), m_loop( 0 ), m_nValues( 0 ), m_nBad( 0 ), m_nAlarms( 0 ), m_nText( 0 ), m_nBadText( 0 )
+  {
+    memset( m_text, ' ', sizeof( m_text ) );
+  }
+
+  // line 1 as set by SetJetiboxText(), padded with blanks
+  void SetText( const char * text )
+  {
+    memcpy( m_text[ 1 ], m_text[ 0 ], 16 );
+    memset( m_text[ 0 ], ' ', 16 );
+    memcpy( m_text[ 0 ], text, strlen( text ) );
+  }
+
+  virtual void OnSymbol( uint16_t symbol, uint64_t tiEndUs ) { m_decoder.Put( symbol, tiEndUs ); }
+
+  virtual void OnValue( const JetiExValue & v, uint64_t tiUs )
+  {
+    if( v.devId == HEALTH_DEVID )
+      return;
+    uint32_t age = ( m_loop % VALUE_WRAP + VALUE_WRAP - (uint32_t)v.value ) % VALUE_WRAP;
+    if( v.value < 0 || v.value >= VALUE_WRAP || age > MAX_AGE )
+      m_nBad++;
+    m_nValues++;
+  }
+  virtual void OnAlarm( char code, bool bSound, uint64_t tiUs ) { m_nAlarms++; }
+  virtual void OnText( const char * text, uint64_t tiUs )
+  {
+    if( memcmp( text, m_text[ 0 ], 16 ) != 0 && memcmp( text, m_text[ 1 ], 16 ) != 0 )
+      m_nBadText++;                // mix of old and new text
+    m_nText++;
+  }
+
+  JetiExDecoder m_decoder;
+  char          m_text[ 2 ][ 16 ]; // last and previous line 1
+  uint32_t      m_loop;          // loop counter of the last values set
+  uint32_t      m_nValues;
+  uint32_t      m_nBad;          // value from the future or too old
+  uint32_t      m_nAlarms;
+  uint32_t      m_nText;
+  uint32_t      m_nBadText;
+};
+
+typedef struct
+{
+  uint32_t nCalls;
+  uint32_t maxSymbols;
+  std::vector<uint32_t> modelUs;   // per call
+  std::vector<uint32_t> hostNs;    // per call
+  uint64_t sumModelUs;
+  uint64_t sumHostNs;
+  uint32_t healthMaxUs;            // GetHealth() of the last window
+  uint32_t nExFrames;
+  uint32_t nValues;
+  uint32_t nBad;
+  uint32_t nAlarms;
+  uint32_t nAlarmsSet;
+  uint32_t nText;
+  uint32_t nBadText;
+  uint32_t nErrors;
+}
+Result;
+
+static uint32_t Percentile( const std::vector<uint32_t> & v, int p )   // v must be sorted
+{
+  return v.empty() ? 0 : v[ ( v.size() - 1 ) * p / 100 ];
+}
+
+static void Run( uint32_t seconds, uint32_t nSensors, uint32_t loopUs, uint32_t symbolUs, uint16_t maxUs, uint8_t maxUnits, Result & r )
+{
+  static const uint8_t types[] = { JetiSensor::TYPE_14b, JetiSensor::TYPE_22b, JetiSensor::TYPE_30b };
+
+  std::vector<JetiSensorConst> sensors( nSensors + 1 );
+  memset( &sensors[ 0 ], 0, sensors.size() * sizeof( JetiSensorConst ) );
+  for( uint32_t i = 0; i < nSensors; i++ )
+  {
+    sensors[ i ].id       = i + 1;
+    sensors[ i ].dataType = types[ i % 3 ];
+    snprintf( sensors[ i ].text, sizeof( sensors[ i ].text ), "Sensor %u", i + 1 );
+  }
+
+  JetiExVirtualClock clock;
+  JetiExClock::SetClock( &clock );
+
+  Receiver       receiver;
+  CostUart       uart( &receiver, &clock, symbolUs );
+  JetiExProtocol jetiEx;
+  jetiEx.AddHealthDevice( "Health", Receiver::HEALTH_DEVID & 0xFF, Receiver::HEALTH_DEVID >> 8, 1000 );
+  if( maxUs || maxUnits )
+    jetiEx.SetSendBudget( maxUs, maxUnits );
+  jetiEx.Start( "Bench", &sensors[ 0 ], &uart );
+
+  r.nCalls     = 0;
+  r.maxSymbols = 0;
+  r.sumModelUs = 0;
+  r.sumHostNs  = 0;
+  r.nAlarmsSet = 0;
+  r.modelUs.clear();
+  r.hostNs.clear();
+
+  uint64_t tiEnd  = clock.Micros() + (uint64_t)seconds * 1000000;
+  uint32_t nLoops = 0;
+  while( clock.Micros() < tiEnd )
+  {
+    // loop(): new values, an alarm every 3 s, text every 97 ms (drifts through the send windows)
+    receiver.m_loop = nLoops;
+    for( uint32_t i = 0; i < nSensors; i++ )
+      jetiEx.SetSensorValue( i + 1, nLoops % Receiver::VALUE_WRAP );
+    if( nLoops % ( 3000000 / loopUs ) == 0 && jetiEx.SetJetiAlarm( 'U' ) )
+      r.nAlarmsSet++;
+    if( nLoops % ( 97000 / loopUs ) == 0 )
+    {
+      char text[ 17 ];
+      snprintf( text, sizeof( text ), "loop %u", nLoops );
+      jetiEx.SetJetiboxText( JetiExProtocol::LINE1, text );
+      receiver.SetText( text );
+    }
+    nLoops++;
+
+    // DoJetiSend(): symbols, modelled and host time
+    struct timespec t0, t1;
+    uint64_t tiStart = clock.Micros();
+    uart.m_nCall = 0;
+    clock_gettime( CLOCK_MONOTONIC, &t0 );
+    jetiEx.DoJetiSend();
+    clock_gettime( CLOCK_MONOTONIC, &t1 );
+    uint32_t us = (uint32_t)( clock.Micros() - tiStart );
+    uint32_t ns = (uint32_t)( ( t1.tv_sec - t0.tv_sec ) * 1000000000LL + ( t1.tv_nsec - t0.tv_nsec ) );
+    r.nCalls++;
+    r.maxSymbols = std::max( r.maxSymbols, uart.m_nCall );
+    r.modelUs.push_back( us );
+    r.hostNs.push_back( ns );
+    r.sumModelUs += us;
+    r.sumHostNs  += ns;
+
+    uart.Update( clock.Micros() );
+    clock.Set( tiStart + loopUs > clock.Micros() ? tiStart + loopUs : clock.Micros() );
+  }
+  uart.Update( clock.Micros() + 1000000 );   // flush UART
+
+  JetiExProtocol::Health h;
+  jetiEx.GetHealth( h );
+  r.healthMaxUs = h.sendMaxUs;
+
+  const JetiExDecoder::Stats & ds = receiver.m_decoder.GetStats();
+  r.nExFrames = ds.nExFrames;
+  r.nErrors   = ds.nErrors;
+  r.nValues   = receiver.m_nValues;
+  r.nBad      = receiver.m_nBad;
+  r.nAlarms   = receiver.m_nAlarms;
+  r.nText     = receiver.m_nText;
+  r.nBadText  = receiver.m_nBadText;
+  std::sort( r.modelUs.begin(), r.modelUs.end() );
+  std::sort( r.hostNs.begin(), r.hostNs.end() );
+
+  JetiExClock::SetClock( 0 );
+}
+
+static void Print( const char * name, const Result & r )
+{
+  printf( "%-12s %9u %7u %8u %8u %8.1f %8u %8u %8.1f %8u %7u %5u/%-5u %6u %4u %4u %4u\n", name, r.nCalls, r.maxSymbols,
+          r.modelUs.back(), Percentile( r.modelUs, 99 ), r.sumModelUs / (double)r.nCalls, r.hostNs.back(), Percentile( r.hostNs, 99 ),
+          r.sumHostNs / (double)r.nCalls, r.nExFrames, r.nValues, r.nAlarms, r.nAlarmsSet, r.nText, r.nBadText, r.nBad, r.nErrors );
+}
+
+int main( int argc, char ** argv )
+{
+  uint32_t seconds  = 60;
+  uint32_t nSensors = 16;
+  uint32_t loopUs   = 1000;
+  uint32_t maxUs    = 0;
+  uint32_t maxUnits = 8;
+  uint32_t symbolUs = 5;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[ i ], "-t" ) == 0 && i + 1 < argc )
+      seconds = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-s" ) == 0 && i + 1 < argc )
+      nSensors = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-l" ) == 0 && i + 1 < argc )
+      loopUs = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-u" ) == 0 && i + 1 < argc )
+      maxUs = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-n" ) == 0 && i + 1 < argc )
+      maxUnits = atol( argv[ ++i ] );
+    else if( strcmp( argv[ i ], "-c" ) == 0 && i + 1 < argc )
+      symbolUs = atol( argv[ ++i ] );
+    else
+    {
+      fprintf( stderr, "usage: jetisendbench [-t seconds] [-s sensors] [-l loopUs] [-u maxUs] [-n maxUnits] [-c symbolUs]\n" );
+      return 1;
+    }
+  }
+  if( nSensors < 1 || nSensors > 31 || loopUs < 100 || seconds == 0 || maxUs > 0xFFFF || maxUnits > 255 || ( maxUs == 0 && maxUnits == 0 ) )
+  {
+    fprintf( stderr, "sensors 1..31, loop >= 100 us, seconds > 0, budget: maxUs 0..65535 and/or maxUnits 1..255\n" );
+    return 1;
+  }
+
+  Result plain, sliced;
+  Run( seconds, nSensors, loopUs, symbolUs, 0, 0, plain );
+  Run( seconds, nSensors, loopUs, symbolUs, maxUs, maxUnits, sliced );
+
+  printf( "%u s, %u sensors, loop %u us, %u us per symbol, budget: %u us, %u units\n\n", seconds, nSensors, loopUs, symbolUs, maxUs, maxUnits );
+  printf( "                 calls symbols   max us   p99 us  mean us   max ns   p99 ns  mean ns EXframes  values alarms      text  mix  bad  err\n" );
+  Print( "plain", plain );
+  Print( "time-sliced", sliced );
+  printf( "\nhealth send max (last window): plain %u us, time-sliced %u us\n", plain.healthMaxUs, sliced.healthMaxUs );
+
+  // budget and stream checks
+  bool bOk = sliced.nBad == 0 && sliced.nBadText == 0 && plain.nBadText == 0 && sliced.nErrors == 0 && plain.nBad == 0 && plain.nErrors == 0 &&
+             sliced.nAlarms + 1 >= sliced.nAlarmsSet && sliced.nText > 0 && sliced.nExFrames * 10 >= plain.nExFrames * 9;
+  if( maxUnits && sliced.maxSymbols > maxUnits )
+    bOk = false;
+  if( maxUs && sliced.modelUs.back() > maxUs + symbolUs )
+    bOk = false;
+  printf( "%s\n", bOk ? "ok" : "BOUND OR STREAM CHECK FAILED" );
+  return bOk ? 0 : 2;
+}
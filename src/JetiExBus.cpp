@@ -0,0 +1,467 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExBus - EX Bus transport
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     channel packets are parsed in receiver ISR (AVR), double buffered channels
+                     answer bytes and loop timing for health values
+                     value log is written in DoJetiSend()
+                     frame pipeline: next EX frame is assembled between the requests
+                     DoJetiSend() duration for health values
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "JetiExBus.h"
+#include "JetiExLog.h"
+
+JetiExBus::JetiExBus() : m_pBus( 0 ), m_bRxIsr( false ), m_reqId( 0 ), m_reqPacketId( 0 ), m_tiRequest( 0 ),
+                         m_chFront( 0 ), m_chSeq( 0 ), m_chSeqRead( 0 ), m_key( 0 )
+{
+  memset( &m_stats, 0, sizeof( m_stats ) );
+  memset( m_chBuf, 0, sizeof( m_chBuf ) );
+}
+
+void JetiExBus::Start( const char * name, JETISENSOR_CONST * pSensorArray, enComPort comPort, enBaud baud )
+{
+  // call it once only !
+  if( m_devices[ 0 ].nameLen != 0 )
+    return;
+
+  Start( name, pSensorArray, JetiExBusSerial::CreatePort( comPort ), baud );
+}
+
+void JetiExBus::Start( const char * name, JETISENSOR_PACKED * pSensors, const char * pPool, JetiExBusSerial * pBus, enBaud baud )
+{
+  if( m_devices[ 0 ].nSensors == 0 )
+    InitSensorMapper( 0, 0, pSensors, pPool );
+  Start( name, (JETISENSOR_CONST*)0, pBus, baud );
+}
+
+void JetiExBus::Start( const char * name, JETISENSOR_CONST * pSensorArray, JetiExBusSerial * pBus, enBaud baud )
+{
+  // no startup dictionary phase: the receiver polls, the dictionary is sent in the first answers
+  if( InitStart( name, pSensorArray ) < 0 )
+    return;
+
+  m_pBus     = pBus;
+  m_symbolUs = baud == BAUD_250K ? 40 : 80;                   // link load: time per answer byte
+  m_pBus->Init( baud == BAUD_250K ? 250000 : 125000 );
+  m_bRxIsr = m_pBus->Attach( this );
+}
+
+uint8_t JetiExBus::DoJetiSend()
+{
+  if( m_pBus == 0 ) // Start() has not been called
+    return 0;
+
+  HealthLoop();
+  if( m_pLog )
+    m_pLog->Poll();
+
+  // threshold alarms in debounce time
+  if( m_rulesPending )
+    CheckPendingRules();
+
+  if( !m_bRxIsr )
+  {
+    int c;
+    while( ( c = m_pBus->Read() ) >= 0 )
+      OnReceive( (uint8_t)c );
+  }
+
+  // answer request, if the receiver is still waiting
+  uint8_t reqId, packetId;
+  {
+    JETIEX_LOCK();
+    reqId    = m_reqId;
+    packetId = m_reqPacketId;
+    m_reqId  = 0;
+    if( reqId && (unsigned long)( micros() - m_tiRequest ) > RESPONSE_US )
+    {
+      m_stats.nMissed++;
+      reqId = 0;
+    }
+    JETIEX_UNLOCK();
+  }
+  if( reqId == ID_TELEMETRY )
+    SendTelemetry( packetId );
+  else if( reqId == ID_JETIBOX )
+    SendJetibox( packetId );
+  else if( m_pPipeBuffer )
+    BuildNext();                                 // next EX frame, one step per call
+
+  HealthLoopEnd();
+  return 0;
+}
+
+uint8_t JetiExBus::GetJetiboxKey()
+{
+  JETIEX_LOCK();
+  uint8_t c = m_key;
+  m_key = 0;
+  JETIEX_UNLOCK();
+  return c;
+}
+
+bool JetiExBus::GetChannels( Channels & channels )
+{
+  JETIEX_LOCK();
+  channels    = m_chBuf[ m_chFront ];
+  bool bNew   = m_chSeq != m_chSeqRead;
+  m_chSeqRead = m_chSeq;
+  JETIEX_UNLOCK();
+  return bNew;
+}
+
+uint8_t JetiExBus::GetNumChannels()
+{
+  return m_chBuf[ m_chFront ].n;
+}
+
+uint16_t JetiExBus::GetChannel( uint8_t ch )
+{
+  JETIEX_LOCK();
+  const Channels & front = m_chBuf[ m_chFront ];
+  uint16_t value = ch < front.n ? front.values[ ch ] : 0;
+  JETIEX_UNLOCK();
+  return value;
+}
+
+bool JetiExBus::HasNewChannels()
+{
+  JETIEX_LOCK();
+  bool bNew   = m_chSeq != m_chSeqRead;
+  m_chSeqRead = m_chSeq;
+  JETIEX_UNLOCK();
+  return bNew;
+}
+
+JetiExBus::Stats JetiExBus::GetBusStats()
+{
+  JETIEX_LOCK();
+  m_stats.nLost = m_parser.GetErrors();
+  Stats stats   = m_stats;
+  JETIEX_UNLOCK();
+  return stats;
+}
+
+// byte from receiver, constant time
+void JetiExBus::OnReceive( uint8_t c )
+{
+  // receiver goes on: request has not been answered in time
+  if( m_reqId )
+  {
+    m_reqId = 0;
+    m_stats.nMissed++;
+  }
+
+  if( m_parser.Put( c ) )
+  {
+    OnPacket( m_parser.GetPacket(), m_parser.GetLength() );
+    return;
+  }
+
+  // channel packet in progress: store value when its high byte (odd index from 7) has arrived
+  uint8_t i = m_parser.GetCount();
+  if( i >= 8 && ( i & 1 ) == 0 )
+  {
+    const uint8_t * p  = m_parser.GetPacket();
+    uint8_t         ch = ( i - 8 ) / 2;
+    if( p[ 0 ] == HDR_CHANNEL && p[ 4 ] == ID_CHANNEL && i - 6 <= p[ 5 ] && ch < MAX_CHANNELS )
+      m_chBuf[ m_chFront ^ 1 ].values[ ch ] = p[ i - 2 ] | ( c << 8 );
+  }
+}
+
+void JetiExBus::OnPacket( const uint8_t * pPacket, uint8_t len )
+{
+  uint8_t subLen = pPacket[ 5 ];
+  m_stats.nPackets++;
+  if( subLen + 8 > len )
+    return;
+
+  switch( pPacket[ 4 ] )
+  {
+  case ID_CHANNEL:
+  {
+    // values are already in the back buffer: publish it
+    Channels & back = m_chBuf[ m_chFront ^ 1 ];
+    uint8_t    n    = subLen / 2;
+    back.n     = n > (uint8_t)MAX_CHANNELS ? (uint8_t)MAX_CHANNELS : n;
+    back.tiUs  = micros();
+    back.nLost = m_parser.GetErrors();
+    m_chFront ^= 1;
+    m_chSeq++;
+    m_stats.nChannel++;
+    break;
+  }
+  case ID_JETIBOX:
+    if( pPacket[ 0 ] == HDR_REQUEST && subLen > 0 )
+    {
+      uint8_t key = pPacket[ 6 ];
+      if( key != 0xF0 && ( key & 0x0F ) == 0 )   // upper nibble: pressed keys
+      {
+        m_key          = key;
+        m_bTextChanged = true;
+      }
+    }
+    // fall through
+  case ID_TELEMETRY:
+    if( pPacket[ 0 ] == HDR_REQUEST )
+    {
+      m_reqId       = pPacket[ 4 ];
+      m_reqPacketId = pPacket[ 3 ];
+      m_tiRequest   = micros();
+    }
+    break;
+  }
+}
+
+// EX frame, alarm or Jetibox exit
+void JetiExBus::SendTelemetry( uint8_t packetId )
+{
+  uint8_t ctrl[ 3 ];
+  char    alarm = NextAlarm();
+  if( alarm )
+  {
+    bool bSound = !islower( alarm );             // upper case character produces sound, lower case is silent
+    ctrl[ 0 ] = 0x02;                              // same as alarm frame of EX protocol, w/o separator
+    ctrl[ 1 ] = 0x22 | ( bSound ? 0x01 : 0x00 );
+    ctrl[ 2 ] = toupper( alarm );
+    SendAnswer( ID_TELEMETRY, packetId, ctrl, 3 );
+  }
+  else if( m_bExitNav )
+  {
+    m_bExitNav     = false;
+    m_bTextChanged = true;
+    ctrl[ 0 ] = 0x91;
+    ctrl[ 1 ] = 0x31;
+    SendAnswer( ID_TELEMETRY, packetId, ctrl, 2 );
+  }
+  else
+  {
+    uint8_t dev = m_pPipeBuffer ? FinishFrame() : NextDevice();
+    if( dev >= m_nDevices )
+      return;
+    uint8_t n;
+    if( m_pPipeBuffer )
+    {
+      n = m_buildN;                              // assembled since the last answer
+      SwapFrame();
+    }
+    else
+      n = BuildExFrame( dev, m_devices[ dev ].frameCnt++ );
+    SendAnswer( ID_TELEMETRY, packetId, m_exBuffer + 1, n );  // EX frame from byte 1 to crc8
+    ExFrameSent( dev, n );
+  }
+  m_stats.nTelemetry++;
+}
+
+void JetiExBus::SendJetibox( uint8_t packetId )
+{
+  uint8_t text[ 32 ];
+  if( m_textBuffer[ 0 ] != '\0' )
+    memcpy( text, m_textBuffer, sizeof( text ) );
+  else
+    memset( text, 0, sizeof( text ) );           // empty message
+  SendAnswer( ID_JETIBOX, packetId, text, sizeof( text ) );
+  m_stats.nJetibox++;
+}
+
+void JetiExBus::SendAnswer( uint8_t dataId, uint8_t packetId, const uint8_t * pData, uint8_t n )
+{
+  uint8_t len = n + 8;
+  m_answer[ 0 ] = HDR_ANSWER;
+  m_answer[ 1 ] = 0x01;
+  m_answer[ 2 ] = len;
+  m_answer[ 3 ] = packetId;
+  m_answer[ 4 ] = dataId;
+  m_answer[ 5 ] = n;
+  memcpy( m_answer + 6, pData, n );
+  uint16_t crc = JetiExBusParser::Crc16( m_answer, len - 2 );
+  m_answer[ len - 2 ] = crc & 0xFF;
+  m_answer[ len - 1 ] = crc >> 8;
+  m_pBus->Write( m_answer, len );
+  m_nSymbols += len;
+}
+
+// **************************************
+// Packet parser
+// **************************************
+
+bool JetiExBusParser::Put( uint8_t c )
+{
+  // wait for header: 0x3E, 0x3D (receiver) or 0x3B (sensor)
+  if( m_n == 0 )
+  {
+    if( c != 0x3E && c != 0x3D && c != 0x3B )
+      return false;
+    m_crc = 0;
+  }
+
+  m_buf[ m_n++ ] = c;
+  if( m_n == 3 && ( c < MIN_PACKET || c > MAX_PACKET ) )
+  {
+    m_n = 0;
+    m_nErrors++;
+    return false;
+  }
+
+  // header and data: update crc, crc16 bytes: wait for end of packet
+  if( m_n <= 3 || m_n <= m_buf[ 2 ] - 2 )
+  {
+    m_crc = Crc16Update( m_crc, c );
+    return false;
+  }
+  if( m_n < m_buf[ 2 ] )
+    return false;
+
+  m_n = 0;
+  uint8_t len = m_buf[ 2 ];
+  if( m_crc != ( m_buf[ len - 2 ] | ( m_buf[ len - 1 ] << 8 ) ) )
+  {
+    m_nErrors++;
+    return false;
+  }
+  return true;
+}
+
+// crc16 CCITT as in Jeti EX Bus specification
+uint16_t JetiExBusParser::Crc16Update( uint16_t crc, uint8_t data )
+{
+  data ^= (uint8_t)( crc & 0xFF );
+  data ^= data << 4;
+  return ( ( ( (uint16_t)data << 8 ) | ( ( crc & 0xFF00 ) >> 8 ) ) ^ (uint8_t)( data >> 4 ) ^ ( (uint16_t)data << 3 ) );
+}
+
+uint16_t JetiExBusParser::Crc16( const uint8_t * p, uint8_t n )
+{
+  uint16_t crc = 0;
+  while( n-- )
+    crc = Crc16Update( crc, *p++ );
+  return crc;
+}
+
+// **************************************
+// Serial ports
+// **************************************
+
+#ifdef CORE_TEENSY
+
+  JetiExBusSerial * JetiExBusSerial::CreatePort( int comPort )
+  {
+    return new JetiExBusTeensySerial( comPort );
+  }
+
+  JetiExBusTeensySerial::JetiExBusTeensySerial( int comPort ) : m_nEcho( 0 )
+  {
+    switch( comPort )
+    {
+    default:
+    case 2: m_pSerial = &Serial2; break;
+    case 1: m_pSerial = &Serial1; break;
+    case 3: m_pSerial = &Serial3; break;
+    }
+  }
+
+  void JetiExBusTeensySerial::Init( uint32_t baud )
+  {
+    m_pSerial->begin( baud, SERIAL_8N1 );
+  }
+
+  int JetiExBusTeensySerial::Read()
+  {
+    while( m_pSerial->available() > 0 )
+    {
+      int c = m_pSerial->read();
+      if( m_nEcho == 0 )
+        return c;
+      m_nEcho--;                                   // own answer
+    }
+    return -1;
+  }
+
+  void JetiExBusTeensySerial::Write( const uint8_t * pData, uint8_t n )
+  {
+    m_nEcho += n;
+    m_pSerial->write( pData, n );
+  }
+
+#elif defined( JETIEX_HOST )
+
+  JetiExBusSerial * JetiExBusSerial::CreatePort( int comPort )
+  {
+    return new JetiExBusHostSerial();
+  }
+
+#else
+
+  JetiExBusSerial * JetiExBusSerial::CreatePort( int comPort )
+  {
+    return new JetiExBusAtMegaSerial();
+  }
+
+  void JetiExBusAtMegaSerial::Init( uint32_t baud )
+  {
+    uint16_t ubrr = F_CPU / 16 / baud - 1;         // 16 MHz: 7 (125k), 3 (250k), 8 MHz: 3, 1
+    UCSRA = 0x00;
+    UCSRB = m_ucsrb;                               // receiver on, transmitter off
+    UCSRC = _BV(UCSZ0) | _BV(UCSZ1);               // 8N1
+    UBRRH = ubrr >> 8;
+    UBRRL = ubrr & 0xFF;
+  }
+
+  int JetiExBusAtMegaSerial::Read()
+  {
+    if( UCSRA & _BV(RXC) )
+      return UDR;
+    return -1;
+  }
+
+  void JetiExBusAtMegaSerial::Write( const uint8_t * pData, uint8_t n )
+  {
+    UCSRB = _BV(TXEN);                             // receiver off: no echo on single wire
+    while( n-- )
+    {
+      while( !( UCSRA & _BV(UDRE) ) )
+        ;
+      UCSRA |= _BV(TXC);                           // clear transmit complete
+      UDR = *pData++;
+    }
+    while( !( UCSRA & _BV(TXC) ) )
+      ;
+    UCSRB = m_ucsrb;                               // release bus
+  }
+
+  // receiver interrupt: USART_RX_vect (JetiExSerial.cpp) passes the bytes to pHandler
+  bool JetiExBusAtMegaSerial::Attach( JetiExRxHandler * pHandler )
+  {
+    _pRxHandler = pHandler;
+    m_ucsrb     = _BV(RXEN) | _BV(RXCIE);
+    UCSRB       = m_ucsrb;
+    return true;
+  }
+
+#endif // CORE_TEENSY
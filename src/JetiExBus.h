@@ -0,0 +1,250 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExBus - EX Bus transport
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+                     channel packets are parsed in receiver ISR (AVR), double buffered channels
+
+  EX Bus is the bidirectional, half duplex bus of newer Jeti receivers (125 or 250 kbaud, 8N1).
+  The receiver is the bus master, it sends channel values and polls the sensors:
+
+    receiver:  0x3E 0x01 len id 0x31 sublen channels (2 bytes each, 1/8 us)        crc16   no answer
+               0x3D 0x01 len id 0x3A 0x00                                           crc16   telemetry request
+               0x3D 0x01 len id 0x3B 0x01 key                                       crc16   Jetibox request
+    sensor:    0x3B 0x01 len id 0x3A sublen EX frame (w/o 0x7E separator) or alarm  crc16
+               0x3B 0x01 len id 0x3B 0x20   Jetibox text (32 characters)            crc16
+
+  len is the packet length incl. header and crc16 (CCITT, little endian), the answer repeats
+  the packet id of the request and must start within RESPONSE_US after the end of the request.
+  JetiExBus uses the sensor arrays, value encoders, dictionary logic, alarms and Jetibox texts
+  of JetiExProtocol, only the transport is different.
+
+  Usage: like JetiExProtocol, call DoJetiSend() as often as possible (answer deadline), i.e.
+    JetiExBus jetiEx;
+    jetiEx.Start( "ECU", sensors, JetiExProtocol::SERIAL2, JetiExBus::BAUD_125K );
+
+  Channels: if the port supports a receiver interrupt (Attach(), ATMega), all bytes are parsed in the ISR
+  with constant cost per byte (crc16 is updated with every byte, channel values are stored as they arrive).
+  A valid channel packet is published by switching the double buffer, GetChannels() returns a consistent
+  copy with the time of reception and the number of packets lost so far, independent of the loop() timing.
+  Without receiver interrupt (Teensy: the core owns the UART ISR) the bytes are parsed in DoJetiSend().
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+#ifndef JETIEXBUS_H
+#define JETIEXBUS_H
+
+#include "JetiExProtocol.h"
+
+// 8 bit half duplex serial port for EX Bus
+///////////////////////////////////////////
+class JetiExBusSerial
+{
+public:
+  static JetiExBusSerial * CreatePort( int comPort ); // comPort: 0=default, Teensy: 1..3
+
+  virtual ~JetiExBusSerial() {}
+  virtual void Init( uint32_t baud ) = 0;
+  virtual int  Read() = 0;                                  // -1: no data
+  virtual void Write( const uint8_t * pData, uint8_t n ) = 0; // answer, receiver is off (or echo is discarded) while sending
+  virtual bool Attach( JetiExRxHandler * pHandler ) { return false; } // true: received bytes are passed to pHandler from ISR, Read() is not used
+};
+
+// Teensy
+/////////
+#ifdef CORE_TEENSY
+
+  // single wire: TX via diode to RX, the echo of own bytes is discarded
+  class JetiExBusTeensySerial final : public JetiExBusSerial
+  {
+  public:
+    JetiExBusTeensySerial( int comPort = 2 );
+    virtual void Init( uint32_t baud );
+    virtual int  Read();
+    virtual void Write( const uint8_t * pData, uint8_t n );
+  protected:
+    HardwareSerial * m_pSerial;
+    uint8_t          m_nEcho;
+  };
+
+// Host (Linux)
+///////////////
+#elif defined( JETIEX_HOST )
+
+  // default port for host builds: no receiver, use Start() with your own port (i.e. JetiExBusSim in extras/host)
+  class JetiExBusHostSerial final : public JetiExBusSerial
+  {
+  public:
+    virtual void Init( uint32_t baud ) {}
+    virtual int  Read() { return -1; }
+    virtual void Write( const uint8_t * pData, uint8_t n ) {}
+  };
+
+#else
+
+  // ATMega: transmitter is on while sending only (half duplex), receiver polled or interrupt driven (Attach)
+  // Write() waits until the answer has been sent (2.6 ms for a full EX frame at 125 kbaud)
+  class JetiExBusAtMegaSerial final : public JetiExBusSerial
+  {
+  public:
+    JetiExBusAtMegaSerial() : m_ucsrb( _BV(RXEN) ) {}
+    virtual void Init( uint32_t baud );
+    virtual int  Read();
+    virtual void Write( const uint8_t * pData, uint8_t n );
+    virtual bool Attach( JetiExRxHandler * pHandler );
+  protected:
+    uint8_t m_ucsrb;   // receiver state
+  };
+
+#endif // CORE_TEENSY
+
+// EX Bus packet parser: header, length and crc16 check
+// constant time per byte, crc16 is updated with every byte
+///////////////////////////////////////////////////////
+class JetiExBusParser
+{
+public:
+  enum
+  {
+    MAX_PACKET = 64,   // 24 channels
+    MIN_PACKET = 8,    // header + crc16
+  };
+
+  JetiExBusParser() : m_n( 0 ), m_crc( 0 ), m_nErrors( 0 ) {}
+
+  bool Put( uint8_t c );                                   // true: valid packet is complete
+  void Reset() { m_n = 0; }
+  bool IsIdle() const { return m_n == 0; }                 // no packet in progress
+
+  const uint8_t * GetPacket() const { return m_buf; }      // valid until next Put()
+  uint8_t         GetLength() const { return m_buf[ 2 ]; }
+  uint8_t         GetCount() const { return m_n; }         // bytes of packet in progress
+  uint32_t        GetErrors() const { return m_nErrors; }  // lost packets: bad crc or length
+
+  static uint16_t Crc16Update( uint16_t crc, uint8_t data );
+  static uint16_t Crc16( const uint8_t * p, uint8_t n );
+
+protected:
+  uint8_t  m_buf[ MAX_PACKET ];
+  uint8_t  m_n;
+  uint16_t m_crc;
+  uint32_t m_nErrors;
+};
+
+// Jeti EX protocol on EX Bus
+/////////////////////////////
+class JetiExBus : public JetiExProtocol, public JetiExRxHandler
+{
+public:
+  enum enBaud
+  {
+    BAUD_125K = 0,
+    BAUD_250K = 1,
+  };
+
+  enum
+  {
+    // header
+    HDR_CHANNEL   = 0x3E,   // receiver, no answer
+    HDR_REQUEST   = 0x3D,   // receiver, answer expected
+    HDR_ANSWER    = 0x3B,   // sensor
+
+    // data identifier
+    ID_CHANNEL    = 0x31,
+    ID_TELEMETRY  = 0x3A,
+    ID_JETIBOX    = 0x3B,
+
+    MAX_CHANNELS  = 24,
+    RESPONSE_US   = 4000,   // answer must start within 4 ms, late answers are dropped (bus collision)
+  };
+
+  typedef struct
+  {
+    uint32_t nPackets;      // valid packets from receiver
+    uint32_t nChannel;      // channel packets
+    uint32_t nTelemetry;    // telemetry requests answered
+    uint32_t nJetibox;      // Jetibox requests answered
+    uint32_t nMissed;       // requests not answered: too late or bus busy
+    uint32_t nLost;         // packets with bad crc or length
+  }
+  Stats;
+
+  typedef struct
+  {
+    uint16_t      values[ MAX_CHANNELS ];  // 1/8 us (8000..16000 = 1..2 ms)
+    uint8_t       n;                       // number of channels
+    unsigned long tiUs;                    // micros() at end of packet
+    uint32_t      nLost;                   // packets lost since Start(), bad crc or length
+  }
+  Channels;
+
+  JetiExBus();
+
+  void    Start( const char * name, JETISENSOR_CONST * pSensorArray, enComPort comPort = DEFAULTPORT, enBaud baud = BAUD_125K );
+  void    Start( const char * name, JETISENSOR_CONST * pSensorArray, JetiExBusSerial * pBus, enBaud baud = BAUD_125K );
+  void    Start( const char * name, JETISENSOR_PACKED * pSensors, const char * pPool, JetiExBusSerial * pBus, enBaud baud = BAUD_125K );
+  uint8_t DoJetiSend();                                    // call as often as possible in loop(), answers the requests of the receiver
+  uint8_t GetJetiboxKey();
+
+  // channel values from the last channel packet
+  bool     GetChannels( Channels & channels );             // copy of last channel packet, true: new since last call
+  uint8_t  GetNumChannels();
+  uint16_t GetChannel( uint8_t ch );
+  bool     HasNewChannels();
+
+  Stats    GetBusStats();
+
+  virtual void OnReceive( uint8_t c );                      // byte from receiver, called from ISR or DoJetiSend()
+
+protected:
+  void OnPacket( const uint8_t * pPacket, uint8_t len );
+  void SendTelemetry( uint8_t packetId );
+  void SendJetibox( uint8_t packetId );
+  void SendAnswer( uint8_t dataId, uint8_t packetId, const uint8_t * pData, uint8_t n );
+
+  JetiExBusSerial * m_pBus;
+  bool              m_bRxIsr;              // bytes are received in ISR
+  JetiExBusParser   m_parser;
+  Stats             m_stats;
+
+  // pending request
+  volatile uint8_t       m_reqId;          // data identifier, 0: none
+  volatile uint8_t       m_reqPacketId;
+  volatile unsigned long m_tiRequest;      // us, end of request
+
+  // channels: the receiver writes to m_chBuf[ m_chFront ^ 1 ], a valid packet switches the buffers
+  Channels          m_chBuf[ 2 ];
+  volatile uint8_t  m_chFront;
+  volatile uint8_t  m_chSeq;               // incremented with every published packet
+  uint8_t           m_chSeqRead;           // m_chSeq of last GetChannels()/HasNewChannels()
+
+  // Jetibox key from last request
+  volatile uint8_t  m_key;
+
+  // answer buffer: header, 32 text characters, crc16
+  uint8_t           m_answer[ 6 + 32 + 2 ];
+};
+
+#endif // JETIEXBUS_H
@@ -0,0 +1,66 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExHost - Arduino runtime replacement for host (Linux) builds
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "JetiExHost.h"
+
+#ifdef JETIEX_HOST
+
+#include <time.h>
+
+static JetiExClock              _systemClock;
+static thread_local JetiExClock * _pClock = 0;   // time source per thread
+
+uint64_t JetiExClock::Micros()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void JetiExClock::Delay( uint32_t ms )
+{
+  struct timespec ts;
+  ts.tv_sec  = ms / 1000;
+  ts.tv_nsec = ( ms % 1000 ) * 1000000L;
+  nanosleep( &ts, 0 );
+}
+
+void JetiExClock::SetClock( JetiExClock * pClock )
+{
+  _pClock = pClock;
+}
+
+JetiExClock * JetiExClock::GetClock()
+{
+  return _pClock ? _pClock : &_systemClock;
+}
+
+#endif // JETIEX_HOST
@@ -0,0 +1,100 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExHost - Arduino runtime replacement for host (Linux) builds
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Compile the library with -DJETIEX_HOST to run it on a PC:
+  - millis()/micros()/delay() are routed to an exchangeable time source (JetiExClock),
+    JetiExVirtualClock lets simulations and replays run faster than real time
+  - the time source is selected per thread, so independent protocol instances
+    can run in parallel threads
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef JETIEXHOST_H
+#define JETIEXHOST_H
+
+#ifdef JETIEX_HOST
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+// Arduino types and PROGMEM access
+///////////////////////////////////
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define PSTR(s)             (s)
+#define memcpy_P            memcpy
+#define strlen_P            strlen
+#define pgm_read_byte(p)    (*(const uint8_t*)(p))
+#define pgm_read_word(p)    (*(const uint16_t*)(p))
+
+// time source
+//////////////
+class JetiExClock
+{
+public:
+  virtual ~JetiExClock() {}
+
+  virtual uint64_t Micros();             // default: monotonic system clock
+  virtual void     Delay( uint32_t ms ); // default: sleep
+
+  // time source of the calling thread, 0 restores the system clock
+  static void          SetClock( JetiExClock * pClock );
+  static JetiExClock * GetClock();
+};
+
+// virtual time, advanced by delay() or explicitly by the simulation
+class JetiExVirtualClock : public JetiExClock
+{
+public:
+  JetiExVirtualClock( uint64_t us = 0 ) : m_us( us ) {}
+
+  virtual uint64_t Micros() { return m_us; }
+  virtual void     Delay( uint32_t ms ) { m_us += (uint64_t)ms * 1000; }
+
+  void Set( uint64_t us ) { m_us = us; }
+  void Advance( uint64_t us ) { m_us += us; }
+
+protected:
+  uint64_t m_us;
+};
+
+// Arduino time functions
+inline unsigned long millis()                    { return (unsigned long)( JetiExClock::GetClock()->Micros() / 1000 ); }
+inline unsigned long micros()                    { return (unsigned long)JetiExClock::GetClock()->Micros(); }
+inline void          delay( unsigned long ms )   { JetiExClock::GetClock()->Delay( ms ); }
+
+#endif // JETIEX_HOST
+
+#endif // JETIEXHOST_H
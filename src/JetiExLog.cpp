@@ -0,0 +1,228 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExLog - full-rate binary value log
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "JetiExLog.h"
+
+static const char _magic[ 7 ] = { 'J', 'E', 'T', 'I', 'L', 'O', 'G' };
+
+JetiExLog::JetiExLog( JetiExLogSink * pSink, uint16_t bufSize )
+  : m_pSink( pSink ), m_bufSize( bufSize ), m_head( 0 ), m_tail( 0 ), m_pPrev( 0 ), m_nSlots( 0 ), m_tiLast( 0 ), m_nGap( 0 )
+{
+  if( m_bufSize < 2 * MAX_RECORD )
+    m_bufSize = 2 * MAX_RECORD;
+  m_pBuf = new uint8_t[ m_bufSize ];
+  memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+JetiExLog::~JetiExLog()
+{
+  delete [] m_pBuf;
+  delete [] m_pPrev;
+}
+
+bool JetiExLog::Begin( uint16_t nSlots )
+{
+  if( nSlots > MAX_SLOTS )
+    return false;
+
+  Flush();
+
+  JETIEX_LOCK();
+  delete [] m_pPrev;
+  m_pPrev  = nSlots ? new int32_t[ nSlots ] : 0;
+  m_nSlots = m_pPrev ? nSlots : 0;
+  if( m_pPrev )
+    memset( m_pPrev, 0, nSlots * sizeof( int32_t ) );
+  m_head   = m_tail = 0;
+  m_nGap   = 0;
+  m_tiLast = millis();
+  JETIEX_UNLOCK();
+
+  uint8_t hdr[ sizeof( _magic ) + 5 ];
+  memcpy( hdr, _magic, sizeof( _magic ) );
+  hdr[ 7 ]  = VERSION;
+  hdr[ 8 ]  = m_tiLast & 0xFF;
+  hdr[ 9 ]  = ( m_tiLast >> 8 ) & 0xFF;
+  hdr[ 10 ] = ( m_tiLast >> 16 ) & 0xFF;
+  hdr[ 11 ] = ( m_tiLast >> 24 ) & 0xFF;
+  WriteSink( hdr, sizeof( hdr ) );
+  return m_nSlots == nSlots;
+}
+
+void JetiExLog::Header( const uint8_t * pData, uint8_t n )
+{
+  WriteSink( pData, n );
+}
+
+// one record: [gap] [time] value
+void JetiExLog::Value( uint16_t slot, int32_t value )
+{
+  if( slot >= m_nSlots )
+    return;
+
+  uint8_t rec[ MAX_RECORD ];
+  uint8_t n = 0;
+
+  JETIEX_LOCK();
+  if( m_nGap )
+  {
+    rec[ n++ ] = REC_GAP;
+    n += PutVarint( rec + n, m_nGap );
+  }
+
+  unsigned long now = millis();
+  unsigned long dt  = now - m_tiLast;
+  if( dt )
+  {
+    if( dt < 63 )
+      rec[ n++ ] = REC_TIME | ( dt << 2 );
+    else
+    {
+      rec[ n++ ] = REC_TIME | ( 63 << 2 );
+      n += PutVarint( rec + n, dt );
+    }
+  }
+
+  if( slot < 63 )
+    rec[ n++ ] = REC_VALUE | ( slot << 2 );
+  else
+  {
+    rec[ n++ ] = REC_VALUE | ( 63 << 2 );
+    n += PutVarint( rec + n, slot );
+  }
+  uint32_t d = (uint32_t)value - (uint32_t)( m_nGap ? 0 : m_pPrev[ slot ] );   // after a gap: difference to 0
+  n += PutVarint( rec + n, ( d << 1 ) ^ (uint32_t)( (int32_t)d >> 31 ) );          // zigzag: small negative differences are short
+
+  uint16_t used = m_head >= m_tail ? m_head - m_tail : m_head + m_bufSize - m_tail;
+  if( used + n >= m_bufSize )
+  {
+    m_nGap++;
+    m_stats.nDropped++;
+  }
+  else
+  {
+    if( m_nGap )
+    {
+      memset( m_pPrev, 0, m_nSlots * sizeof( int32_t ) );
+      m_nGap = 0;
+    }
+    uint16_t head = m_head;
+    for( uint8_t i = 0; i < n; i++ )
+    {
+      m_pBuf[ head ] = rec[ i ];
+      if( ++head >= m_bufSize )
+        head = 0;
+    }
+    m_head          = head;
+    m_pPrev[ slot ] = value;
+    m_tiLast        = now;
+    m_stats.nRecords++;
+    if( used + n > m_stats.highWater )
+      m_stats.highWater = used + n;
+  }
+  JETIEX_UNLOCK();
+}
+
+// contiguous parts of the ring buffer to the sink, as much as it takes
+void JetiExLog::Poll()
+{
+  if( m_pSink == 0 )
+    return;
+
+  uint16_t head;
+  {
+    JETIEX_LOCK();                                   // 16 bit read is not atomic on AVR
+    head = m_head;
+    JETIEX_UNLOCK();
+  }
+
+  uint16_t tail = m_tail;
+  while( tail != head )
+  {
+    uint16_t n = head > tail ? head - tail : m_bufSize - tail;
+    uint16_t w = m_pSink->Write( m_pBuf + tail, n );
+    m_stats.nBytes += w;
+    tail += w;
+    if( tail >= m_bufSize )
+      tail = 0;
+    if( w < n )
+      break;
+  }
+
+  JETIEX_LOCK();
+  m_tail = tail;
+  JETIEX_UNLOCK();
+}
+
+void JetiExLog::Flush()
+{
+  uint16_t tail;
+  do
+  {
+    tail = m_tail;
+    Poll();
+  }
+  while( m_tail != tail && m_tail != m_head );
+}
+
+JetiExLog::Stats JetiExLog::GetStats()
+{
+  JETIEX_LOCK();
+  Stats stats = m_stats;
+  JETIEX_UNLOCK();
+  return stats;
+}
+
+void JetiExLog::WriteSink( const uint8_t * pData, uint16_t n )
+{
+  while( n && m_pSink )
+  {
+    uint16_t w = m_pSink->Write( pData, n );
+    if( w == 0 )
+      break;
+    m_stats.nBytes += w;
+    pData += w;
+    n     -= w;
+  }
+}
+
+// unsigned LEB128
+uint8_t JetiExLog::PutVarint( uint8_t * p, uint32_t v )
+{
+  uint8_t n = 0;
+  while( v >= 0x80 )
+  {
+    p[ n++ ] = ( v & 0x7F ) | 0x80;
+    v >>= 7;
+  }
+  p[ n++ ] = v;
+  return n;
+}
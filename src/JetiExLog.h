@@ -0,0 +1,139 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExLog - full-rate binary value log
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  The EX link carries a value every few hundred ms, the log records every SetSensorValue()
+  call with a ms timestamp to a sink (SD card file on the MCU, file on the host) for post
+  flight analysis. Records are collected in a bounded ring buffer by SetSensorValue() and
+  written to the sink by DoJetiSend(), records which don't fit are dropped and counted.
+
+  Usage:
+    File            file = SD.open( "flight.jlg", FILE_WRITE );
+    JetiExPrintLogSink sink( &file );
+    JetiExLog       log( &sink, 256 );
+    jetiEx.Start( "ECU", sensors );
+    jetiEx.SetLog( &log );                   // after Start(): writes the sensor table header
+    ...
+    log.Flush(); file.flush();               // i.e. on disarm
+
+  Format (decoder: extras/host/JetiExLogFile, jetilog):
+    header:  "JETILOG" + version byte (1), millis() at start (4 bytes, little endian), number of devices,
+             per device: device id lo/hi, name length, name, number of sensors,
+             per sensor: id, data type, precision, text length, text, unit length, unit
+             values refer to sensors by slot, the index of the sensor in the header (all devices)
+    records: tag byte [varint] ...
+             tag bit 0..1: record kind (REC_VALUE, REC_TIME, REC_GAP)
+             REC_VALUE: tag bit 2..7 slot (0..62), 63: slot follows as varint,
+                        followed by the difference to the previous value of the slot (zigzag varint)
+             REC_TIME:  tag bit 2..7 ms since previous time record (1..62), 63: ms follow as varint
+             REC_GAP:   varint number of dropped records, previous values start again at 0
+    varint: unsigned LEB128. A value that changes slowly takes 2 bytes.
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+#ifndef JETIEXLOG_H
+#define JETIEXLOG_H
+
+#include "JetiExProtocol.h"
+
+// log output
+/////////////
+class JetiExLogSink
+{
+public:
+  virtual uint16_t Write( const uint8_t * pData, uint16_t n ) = 0;   // returns bytes written, less than n: try again later
+};
+
+#ifndef JETIEX_HOST
+
+  // any Arduino Print object, i.e. a File of the SD library
+  class JetiExPrintLogSink : public JetiExLogSink
+  {
+  public:
+    JetiExPrintLogSink( Print * pPrint ) : m_pPrint( pPrint ) {}
+    virtual uint16_t Write( const uint8_t * pData, uint16_t n ) { return m_pPrint->write( pData, n ); }
+  protected:
+    Print * m_pPrint;
+  };
+
+#endif // JETIEX_HOST
+
+// value log
+////////////
+// methods called by JetiExProtocol are virtual, the library links without JetiExLog.cpp when no log is used
+class JetiExLog
+{
+public:
+  enum enRecord
+  {
+    REC_VALUE = 0,
+    REC_TIME  = 1,
+    REC_GAP   = 2,
+
+    VERSION   = 1,
+    MAX_SLOTS = 255,
+    MAX_RECORD = 20,      // gap (6) + time (6) + value (8)
+  };
+
+  typedef struct
+  {
+    uint32_t nRecords;    // values logged
+    uint32_t nDropped;    // values lost, ring buffer full
+    uint32_t nBytes;      // bytes written to sink, incl. header
+    uint16_t highWater;   // max. bytes in ring buffer
+  }
+  Stats;
+
+  JetiExLog( JetiExLogSink * pSink, uint16_t bufSize = 128 );
+  virtual ~JetiExLog();
+
+  void  Flush();                                           // write ring buffer to sink until empty
+  Stats GetStats();
+
+  // called by JetiExProtocol
+  virtual bool Begin( uint16_t nSlots );                   // start of header, false: too many sensors or no memory
+  virtual void Header( const uint8_t * pData, uint8_t n ); // header bytes, written to the sink directly
+  virtual void Value( uint16_t slot, int32_t value );      // ring buffer, ISR safe
+  virtual void Poll();                                     // ring buffer to sink, from DoJetiSend()
+
+protected:
+  void    WriteSink( const uint8_t * pData, uint16_t n );
+  static uint8_t PutVarint( uint8_t * p, uint32_t v );
+
+  JetiExLogSink * m_pSink;
+  uint8_t *       m_pBuf;
+  uint16_t        m_bufSize;
+  volatile uint16_t m_head;                                // write position (Value())
+  volatile uint16_t m_tail;                                // read position (Poll())
+  int32_t *       m_pPrev;                                 // previous value per slot
+  uint16_t        m_nSlots;
+  unsigned long   m_tiLast;                                // ms of last time record
+  uint32_t        m_nGap;                                  // records dropped since last gap record
+  Stats           m_stats;
+};
+
+#endif // JETIEXLOG_H
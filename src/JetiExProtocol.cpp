@@ -35,6 +35,26 @@
                      in order to improve behaviour on telemetry reset
   1.04   07/18/2017  dynamic sensor de-/activation
   1.05   11/12/2017  send 3 textframes before start of EX transmission to get transmitter ready
+  1.06   10/18/2026  host (Linux) build with -DJETIEX_HOST, Start() with user supplied serial port
+                     timer mode: frames are sent from timer interrupt (StartTimer(), JetiExTimer.cpp)
+                     multiple virtual EX devices (AddDevice())
+                     Jetibox text frame on change only (SetJetiboxTextRefresh())
+                     serial Poll() with every DoJetiSend()
+                     prioritized alarm queue with repeat and spacing
+                     alarm and exit frames share the send window with the EX frame
+                     threshold alarm rules (SetAlarmRules())
+                     SetSensorActive() sends changed dictionary entries only
+                     dictionary refresh policy (SetDictionaryRefresh()), value frame ratio
+                     sensor filters: EMA, average, min/max hold, decimation (SetSensorFilters())
+                     JETIEX_STATIC_SERIAL: built-in serial port without virtual calls and heap
+                     packed sensor table with label string pool (JetiSensorPacked, extras/host/jetipack)
+                     Start() split into InitStart() and startup dictionary, ExFrameSent() for EX Bus
+                     value validity bit array and timeouts (SetSensorTimeout()), -1 is a regular value
+                     health device (AddHealthDevice()), GetHealth()
+                     value log (SetLog())
+                     wire id remapping (SetIdRemap())
+                     BuildExFrame() split into steps, frame pipeline (SetFramePipeline())
+                     time-sliced sending (SetSendBudget()), NextWindow(), DoJetiSend() duration
 
   Todo:
   - better check for ex buffer overruns
@@ -63,32 +83,69 @@
 **************************************************************/
 
 #include "JetiExProtocol.h"
+#include "JetiExLog.h"
+
+// Timer mode (built-in timer: JetiExTimer.cpp)
+/////////////
+static JetiExProtocol * _pTimerInstance = 0;   // single instance in timer mode
 
 // JetiSensor work data
 ///////////////////////
-JetiSensor::JetiSensor( int arrIdx, JetiExProtocol * pProtocol )
-  : m_id( 0 ), m_value( -1 ), m_bActive( true ), m_textLen( 0 ), m_unitLen( 0 ), m_dataType( 0 ), m_precision( 0 ), m_bufLen( 0 )
+JetiSensor::JetiSensor( int arrIdx, JetiExProtocol * pProtocol, uint8_t dev, bool bLabel )
+  : m_id( 0 ), m_value( 0 ), m_bActive( true ), m_pText( 0 ), m_pUnit( 0 ), m_textLen( 0 ), m_unitLen( 0 ), m_dataType( 0 ), m_precision( 0 ), m_bufLen( 0 )
 {
+  JetiExProtocol::JetiExDevice * pDevice = &pProtocol->m_devices[ dev ];
+
   // sensor state
-  m_bActive = (pProtocol->m_activeSensors[arrIdx >> 3] & (1 << (arrIdx & 7))) ? true : false;
+  m_bActive = (pDevice->activeSensors[arrIdx >> 3] & (1 << (arrIdx & 7))) ? true : false;
   if( !m_bActive )
     return;
 
-  // copy constant data 
-  JetiSensorConst constData;
-  memcpy_P( &constData, &pProtocol->m_pSensorsConst[ arrIdx ], sizeof(JetiSensorConst) );
-
-  m_dataType = constData.dataType; 
-  m_id       = constData.id;
+  // read constant data, the label is copied to the EX buffer by jetiCopyLabel()
+  uint8_t precision;
+  if( pDevice->pSensorsPacked )
+  {
+    JetiSensorPacked packed;
+    memcpy_P( &packed, &pDevice->pSensorsPacked[ arrIdx ], sizeof( packed ) );
+    m_id       = packed.id;
+    m_dataType = packed.dataType;
+    precision  = packed.precision;
+    if( bLabel )
+    {
+      m_textLen = packed.labelLen >> 3;
+      m_unitLen = packed.labelLen & 0x07;
+      m_pText   = (const uint8_t*)pDevice->pPool + packed.label;
+      m_pUnit   = m_pText + m_textLen;
+      if( m_textLen > MAX_LABEL )                    // hand-written tables: same limits as JETISENSOR_CONST
+        m_textLen = MAX_LABEL;
+      if( m_textLen + m_unitLen > MAX_LABEL )
+        m_unitLen = MAX_LABEL - m_textLen;
+    }
+  }
+  else
+  {
+    JETISENSOR_CONST * pConst = &pDevice->pSensorsConst[ arrIdx ];
+    m_id       = pgm_read_byte( &pConst->id );
+    m_dataType = pgm_read_byte( &pConst->dataType );
+    precision  = pgm_read_byte( &pConst->precision );
+    if( bLabel )
+    {
+      m_pText = (const uint8_t*)pConst->text;
+      m_pUnit = (const uint8_t*)pConst->unit;
+      while( m_textLen < MAX_LABEL && m_textLen < sizeof( pConst->text ) && pgm_read_byte( m_pText + m_textLen ) != '\0' )
+        m_textLen++;
+      while( m_textLen + m_unitLen < MAX_LABEL && m_unitLen < sizeof( pConst->unit ) && pgm_read_byte( m_pUnit + m_unitLen ) != '\0' )
+        m_unitLen++;
+    }
+  }
+  if( pDevice->pWireIds )
+    m_id = pDevice->pWireIds[ arrIdx ];
 
   // value
-  m_value = pProtocol->m_pValues[ arrIdx ].m_value;
-
-  // copy to combined sensor/value buffer
-  copyLabel( (const uint8_t*)constData.text, (const uint8_t*)constData.unit, m_label, sizeof( m_label ), &m_textLen, &m_unitLen );
+  m_value = pDevice->pValues[ arrIdx ].m_value;
 
   // 0...2 decimal places
-  switch( constData.precision )
+  switch( precision )
   {
   case 1: m_precision = 0x20; break; 
   case 2: m_precision = 0x40; break; 
@@ -109,109 +166,1127 @@ JetiSensor::JetiSensor( int arrIdx, JetiExProtocol * pProtocol )
 // JetiExProtocol
 /////////////////
 JetiExProtocol::JetiExProtocol() :
-  m_tiLastSend( 0 ), m_frameCnt( 0 ), m_nameLen( 0 ), m_pSensorsConst( 0 ), m_pValues( 0 ), m_nSensors( 0 ),
-  m_sensorIdx( 0 ), m_dictIdx( 0 ), m_pSerial( 0 ), m_alarmChar( 0 ), m_bExitNav( 0 ), 
-  m_devIdLow( DEVICE_ID_LOW ), m_devIdHi( DEVICE_ID_HI )
+  m_tiLastSend( 0 ), m_sendInterval( SEND_INTERVAL ), m_bTimerMode( false ), m_nDevices( 1 ), m_pSerial( 0 ),
+  m_exBuffer( m_exFrame ), m_pBuild( m_exFrame ), m_pPipeBuffer( 0 ), m_pipeLead( 20 ), m_buildState( BUILD_IDLE ), m_buildDev( 0 ), m_buildN( 0 ), m_buildVal( 0 ),
+  m_budgetUs( 0 ), m_budgetUnits( 0 ), m_outState( OUT_IDLE ), m_outPos( 0 ), m_outN( 0 ), m_nOutCtrl( 0 ), m_bOutText( false ),
+  m_bTextChanged( true ), m_textKeepAlive( 0 ), m_tiLastText( 0 ), m_nAlarms( 0 ), m_nExSkipped( 0 ), m_pRules( 0 ), m_nRules( 0 ), m_rulesPending( 0 ), m_timeoutDev( 0 ), m_timeoutIdx( 0 ),
+  m_dictRefresh( DICT_REFRESH_WRAP ), m_dictTrickle( 16 ), m_nValueFrames( 0 ), m_nDictFrames( 0 ),
+  m_pFilters( 0 ), m_nFilters( 0 ), m_filtersInFrame( 0 ),
+  m_healthDev( 0 ), m_healthInterval( 2000 ), m_symbolUs( JetiExSerial::SYMBOL_US ), m_tiHealth( 0 ), m_nSymbols( 0 ), m_nValuesSent( 0 ), m_valuesInFrame( 0 ),
+  m_tiLoop( 0 ), m_loopMin( 0xFFFFFFFF ), m_loopMax( 0 ), m_sendMax( 0 ), m_sendSum( 0 ), m_nSendCalls( 0 ), m_pLog( 0 ), m_bExitNav( 0 )
 {
-  m_name[0] = '\0';
-  memset( m_activeSensors, 255, sizeof(m_activeSensors) ); // default: all sensors active
-  memset( m_sensorMapper, 0, sizeof( m_sensorMapper ) );
+  memset( &m_health, 0, sizeof( m_health ) );
+  for( uint8_t dev = 0; dev < MAX_DEVICES; dev++ )
+    InitDevice( dev, 0, DEVICE_ID_LOW, DEVICE_ID_HI );
+}
+
+void JetiExProtocol::InitDevice( uint8_t dev, const char * name, uint8_t idLo, uint8_t idHi )
+{
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  memset( pDevice, 0, sizeof( JetiExDevice ) );
+  memset( pDevice->activeSensors, 255, sizeof( pDevice->activeSensors ) ); // default: all sensors active
+  pDevice->devIdLow = idLo;
+  pDevice->devIdHi  = idHi;
+  if( name )
+  {
+    strncpy( pDevice->name, name, sizeof( pDevice->name ) - 1 );
+    pDevice->nameLen = strlen( pDevice->name );
+  }
+}
+
+int JetiExProtocol::AddDevice( const char * name, JETISENSOR_CONST * pSensorArray, uint8_t idLo, uint8_t idHi )
+{
+  // before Start() only
+  if( m_nDevices >= MAX_DEVICES || m_devices[ 0 ].nameLen != 0 || name == 0 || pSensorArray == 0 )
+    return -1;
+
+  uint8_t dev = m_nDevices++;
+  InitDevice( dev, name, idLo, idHi );
+  InitSensorMapper( dev, pSensorArray );
+  return dev;
+}
+
+int JetiExProtocol::AddDevice( const char * name, JETISENSOR_PACKED * pSensors, const char * pPool, uint8_t idLo, uint8_t idHi )
+{
+  if( m_nDevices >= MAX_DEVICES || m_devices[ 0 ].nameLen != 0 || name == 0 || pSensors == 0 || pPool == 0 )
+    return -1;
+
+  uint8_t dev = m_nDevices++;
+  InitDevice( dev, name, idLo, idHi );
+  InitSensorMapper( dev, 0, pSensors, pPool );
+  return dev;
+}
+
+bool JetiExProtocol::SetIdRemap( bool bEnable, const uint8_t * pFastIds, uint8_t dev )
+{
+  static const uint8_t noFastIds[] = { 0 };
+
+  // before Start() only
+  if( dev >= m_nDevices || m_devices[ 0 ].nameLen != 0 )
+    return false;
+
+  m_devices[ dev ].pFastIds = !bEnable ? 0 : pFastIds ? pFastIds : noFastIds;
+  return true;
+}
+
+bool JetiExProtocol::SetSendBudget( uint16_t maxUs, uint8_t maxUnits )
+{
+  // before Start() only
+  if( m_devices[ 0 ].nameLen != 0 )
+    return false;
+
+  m_budgetUs    = 0;
+  m_budgetUnits = 0;
+  if( ( maxUs || maxUnits ) && m_pPipeBuffer == 0 && !SetFramePipeline( true, m_pipeLead ) )
+    return false;
+
+  m_budgetUs    = maxUs;
+  m_budgetUnits = maxUnits;
+  return true;
+}
+
+bool JetiExProtocol::SetFramePipeline( bool bEnable, uint8_t leadMs )
+{
+  // before Start() only
+  if( m_devices[ 0 ].nameLen != 0 )
+    return false;
+
+  delete [] m_pPipeBuffer;
+  m_pPipeBuffer = 0;
+  m_exBuffer    = m_pBuild = m_exFrame;
+  m_buildState  = BUILD_IDLE;
+  m_pipeLead    = leadMs;
+  if( !bEnable )
+  {
+    m_budgetUs = m_budgetUnits = 0;                  // time-sliced sending needs the pipeline
+    return true;
+  }
+  if( ( m_pPipeBuffer = new uint8_t[ sizeof( m_exFrame ) ] ) == 0 )
+    return false;
+
+  memset( m_pPipeBuffer, 0, sizeof( m_exFrame ) );
+  m_pBuild = m_pPipeBuffer;
+  return true;
+}
+
+// health sensors, text + unit max. 19 characters
+static const JetiSensorConst healthSensors[] PROGMEM =
+{
+  { JetiExProtocol::HEALTH_LINK,     "Link load",     "%",   JetiSensor::TYPE_14b, 0 },
+  { JetiExProtocol::HEALTH_REFRESH,  "Value refresh", "ms",  JetiSensor::TYPE_14b, 0 },
+  { JetiExProtocol::HEALTH_TXHIGH,   "TX buffer max", "sym", JetiSensor::TYPE_14b, 0 },
+  { JetiExProtocol::HEALTH_OVERFLOW, "TX overflows",  "",    JetiSensor::TYPE_22b, 0 },
+  { JetiExProtocol::HEALTH_JITTER,   "Loop jitter",   "ms",  JetiSensor::TYPE_14b, 1 },
+  { JetiExProtocol::HEALTH_LOOPMAX,  "Loop max",      "ms",  JetiSensor::TYPE_14b, 1 },
+  { JetiExProtocol::HEALTH_SENDMAX,  "Send max",      "us",  JetiSensor::TYPE_14b, 0 },
+  { 0 }
+};
+
+int JetiExProtocol::AddHealthDevice( const char * name, uint8_t idLo, uint8_t idHi, uint16_t intervalMs )
+{
+  if( m_healthDev != 0 )
+    return -1;
+
+  int dev = AddDevice( name, healthSensors, idLo, idHi );
+  if( dev > 0 )
+  {
+    m_healthDev      = dev;
+    m_healthInterval = intervalMs;
+  }
+  return dev;
+}
+
+void JetiExProtocol::Start( const char * name, JETISENSOR_PACKED * pSensors, const char * pPool, enComPort comPort )
+{
+  if( m_devices[ 0 ].nSensors == 0 )
+    InitSensorMapper( 0, 0, pSensors, pPool );
+  Start( name, (JETISENSOR_CONST*)0, comPort );
+}
+
+void JetiExProtocol::Start( const char * name, JETISENSOR_PACKED * pSensors, const char * pPool, JetiExPort * pSerial )
+{
+  if( m_devices[ 0 ].nSensors == 0 )
+    InitSensorMapper( 0, 0, pSensors, pPool );
+  Start( name, (JETISENSOR_CONST*)0, pSerial );
 }
 
 void JetiExProtocol::Start( const char * name, JETISENSOR_CONST * pSensorArray, enComPort comPort )
 {
   // call it once only !
-  if( m_nameLen != 0 )
+  if( m_devices[ 0 ].nameLen != 0 )
     return;
 
-  // init buffer memory
-  memset( m_exBuffer, 0, sizeof( m_exBuffer ) );
-  memset( m_textBuffer, ' ', sizeof( m_textBuffer ) );
-
-  // sensor name
-  strncpy( m_name, name, sizeof( m_name ) - 1 );
-  m_nameLen = strlen( name );
-
-  // map sensor values
-  if( m_nSensors == 0 ) // dont do it more than once
-    InitSensorMapper( pSensorArray );
+#ifdef JETIEX_STATIC_SERIAL
+#ifdef CORE_TEENSY
+  m_serial.SetComPort( comPort );
+#endif
+  Start( name, pSensorArray, &m_serial );
+#else
+  Start( name, pSensorArray, JetiExSerial::CreatePort( comPort ) );
+#endif
+}
 
-  // init sensor value array
-  m_pValues = new JetiValue[ m_nSensors ];
+void JetiExProtocol::Start( const char * name, JETISENSOR_CONST * pSensorArray, JetiExPort * pSerial )
+{
+  // call it once only !
+  int8_t nDevices = InitStart( name, pSensorArray );
+  if( nDevices < 0 )
+    return;
 
   // init serial port 
-  m_pSerial = JetiExSerial::CreatePort( comPort );
+  m_pSerial = pSerial;
   m_pSerial->Init(); 
 
-  // reset state machine
-  m_sensorIdx = m_dictIdx = m_frameCnt = 0;
-
   // send sensor dictionary for the 1st time
+  uint8_t       dev;
   unsigned long tiLoop = millis() + 2000;
-  while( m_pSensorsConst && tiLoop > millis() )
+  while( nDevices && tiLoop > millis() )
   { 
     int i;
     for( i = 0; i <= 3; i++ )
     { // send 3 text frames to get transmitter ready for EX
       SendJetiboxTextFrame();
-      delay( 150 ); 
+      Wait( 150 ); 
     }
-    for( i = 0; i <= m_nSensors; i++ )
+    for( dev = 0; dev < m_nDevices; dev++ )
     {
-      SendExFrame( i<<1 );
-      SendJetiboxTextFrame();
-      delay( 150 ); 
+      if( !HasSensors( &m_devices[ dev ] ) )
+        continue;
+      for( i = 0; i <= m_devices[ dev ].nSensors; i++ )
+      {
+        SendExFrame( dev, i<<1 );
+        SendJetiboxTextFrame();
+        Wait( 150 ); 
+      }
     }
   }
   while( GetJetiboxKey() ) // flush RX-Queue
     ;         
+
+  m_nValueFrames = m_nDictFrames = 0;
+}
+
+// name, sensor mapper and value arrays, independent of transport
+int8_t JetiExProtocol::InitStart( const char * name, JETISENSOR_CONST * pSensorArray )
+{
+  JetiExDevice * pDevice = &m_devices[ 0 ];
+  if( pDevice->nameLen != 0 )
+    return -1;
+
+  // init buffer memory
+  memset( m_exFrame, 0, sizeof( m_exFrame ) );
+  memset( m_textBuffer, ' ', sizeof( m_textBuffer ) );
+
+  // sensor name
+  strncpy( pDevice->name, name, sizeof( pDevice->name ) - 1 );
+  pDevice->nameLen = strlen( pDevice->name );        // name frame fits into the EX frame buffer
+
+  // map sensor values
+  if( pDevice->nSensors == 0 && pSensorArray ) // dont do it more than once
+    InitSensorMapper( 0, pSensorArray );
+
+  // init sensor value arrays and reset state machines
+  int8_t nDevices = 0;
+  for( uint8_t dev = 0; dev < m_nDevices; dev++ )
+  {
+    pDevice = &m_devices[ dev ];
+    pDevice->pValues   = new JetiValue[ pDevice->nSensors ];
+    pDevice->sensorIdx = pDevice->dictIdx = pDevice->frameCnt = 0;
+    pDevice->nBytes    = 0;
+    if( pDevice->pFastIds && pDevice->nSensors )
+      InitWireIds( dev );
+    if( HasSensors( pDevice ) )
+      nDevices++;
+  }
+
+  // first health window
+  m_tiHealth = millis();
+  m_tiLoop   = 0;
+  return nDevices;
+}
+
+// delay, serial port keeps sending
+void JetiExProtocol::Wait( uint16_t ms )
+{
+  while( ms-- )
+  {
+    m_pSerial->Poll();
+    delay( 1 );
+  }
 }
 
 uint8_t JetiExProtocol::GetJetiboxKey()
 {
   // key handling
-  return m_pSerial->Getchar(); 
+  uint8_t c = m_pSerial->Getchar(); 
+  if( c )
+    m_bTextChanged = true; // answer key with next text frame
+  return c;
 }
 
 uint8_t JetiExProtocol::DoJetiSend()
 {
-  // send every 150 ms only
-  if( ( m_tiLastSend + 150 ) <= millis() )
+  HealthLoop();
+
+  // value log to sink (i.e. SD card), not in timer ISR
+  if( m_pLog )
+    m_pLog->Poll();
+
+  // frames are sent from timer ISR
+  if( !m_bTimerMode )
+    DoSend();
+
+  HealthLoopEnd();
+  return 0;
+}
+
+// pStartIsr: built-in timer, 0: none, the application calls OnTimerTick()
+bool JetiExProtocol::EnterTimerMode( bool ( * pStartIsr )( JetiExProtocol * ) )
+{
+  if( m_pSerial == 0 || _pTimerInstance != 0 ) // after Start() and for a single instance only
+    return false;
+
+  _pTimerInstance = this;
+  m_bTimerMode    = true;
+  if( pStartIsr && !pStartIsr( this ) )        // i.e. Teensy: all PIT channels in use
   {
-    m_tiLastSend = millis(); 
+    m_bTimerMode    = false;
+    _pTimerInstance = 0;
+    return false;
+  }
+  return true;
+}
+
+void JetiExProtocol::LeaveTimerMode( void ( * pStopIsr )() )
+{
+  if( _pTimerInstance != this )
+    return;
+
+  if( pStopIsr )
+    pStopIsr();
+  m_bTimerMode    = false;
+  _pTimerInstance = 0;
+}
+
+// ISR context: serial Send() is interrupt safe, values are written atomically by SetSensorValue()
+void JetiExProtocol::OnTimerTick()
+{
+  if( m_bTimerMode )
+    DoSend();
+}
+
+uint8_t JetiExProtocol::DoSend()
+{
+  if( m_pSerial == 0 ) // Start() has not been called
+    return 0;
+
+  // feed UART
+  m_pSerial->Poll();
 
-    // navigator exit
-    if( m_bExitNav )
+  // threshold alarms in debounce time
+  if( m_rulesPending )
+    CheckPendingRules();
+
+  // expired values, also of sensors which are not sent or not queried
+  CheckNextTimeout();
+
+  // time-sliced: symbols of the window and steps of the next frame until the budget of this call is used up
+  if( m_budgetUs || m_budgetUnits )
+  {
+    unsigned long tiStart = micros();
+    uint8_t       nUnits  = 0;
+    while( SliceStep() )
     {
+      if( ( m_budgetUnits && ++nUnits >= m_budgetUnits ) || ( m_budgetUs && ( micros() - tiStart ) >= m_budgetUs ) )
+        break;
+    }
+    return 0;
+  }
+
+  // send every 150 ms only (70 ms without text frame)
+  if( ( m_tiLastSend + m_sendInterval ) <= millis() )
+  {
+    char    alarm;
+    bool    bExit, bText;
+    uint8_t dev;
+    uint8_t n = NextWindow( dev, alarm, bExit, bText );
+    if( n )
+      SendExBuffer( dev, n );
+
+    if( alarm )
+      SendJetiAlarm( alarm );
+    else if( bExit )
       SendJetiboxExit();
-      m_bExitNav = false;
+
+    // followed by "simple text" frame
+    if( bText )
+      SendJetiboxTextFrame();
+  }
+  // frame pipeline: next frame in steps, during the last m_pipeLead ms
+  else if( m_pPipeBuffer && ( millis() + m_pipeLead ) >= ( m_tiLastSend + m_sendInterval ) )
+    BuildNext();
+
+  return 0;
+}
+
+// content of the send window which is due: EX frame (returns position of crc in m_exBuffer, 0: none), alarm or exit, text frame
+uint8_t JetiExProtocol::NextWindow( uint8_t & dev, char & alarm, bool & bExit, bool & bText )
+{
+  m_tiLastSend = millis(); 
+
+  // morse alarm or navigator exit
+  alarm = NextAlarm();
+  bExit = !alarm && m_bExitNav;
+  uint8_t nCtrl = alarm ? 4 : ( bExit ? 3 : 0 );   // symbols
+  if( bExit )
+  {
+    m_bExitNav     = false;
+    m_bTextChanged = true;
+  }
+  bText = IsTextFrameDue();
+
+  // EX frame of next device, alarm/exit are sent in the same window, if the transmit buffer has space for all
+  dev = m_pPipeBuffer ? FinishFrame() : NextDevice();
+  uint8_t n = 0;
+  if( m_pPipeBuffer && dev < m_nDevices )
+  {
+    // assembled frame is kept for the next send time, if alarm/exit needs the space
+    n = m_buildN;
+    if( nCtrl && ( nCtrl + n + 1 + ( bText ? 34 : 0 ) ) > m_pSerial->TxFree() )
+    {
+      n = 0;
+      m_nExSkipped++;
+    }
+    else
+      SwapFrame();
+  }
+  else if( dev < m_nDevices )
+  {
+    JetiExDevice * pDevice  = &m_devices[ dev ];
+    uint8_t        frameCnt = pDevice->frameCnt, sensorIdx = pDevice->sensorIdx, dictIdx = pDevice->dictIdx;
+    uint8_t        dictState = pDevice->dictState, trickleCnt = pDevice->trickleCnt;
+    n = BuildExFrame( dev, pDevice->frameCnt++ );
+    if( nCtrl && ( nCtrl + n + 1 + ( bText ? 34 : 0 ) ) > m_pSerial->TxFree() )
+    {
+      // does not fit: alarm/exit replaces EX frame
+      pDevice->frameCnt   = frameCnt;
+      pDevice->sensorIdx  = sensorIdx;
+      pDevice->dictIdx    = dictIdx;
+      pDevice->dictState  = dictState;
+      pDevice->trickleCnt = trickleCnt;
+      RestoreFilters();
+      n = 0;
+      m_nExSkipped++;
     }
-    // morse alarm
-    else if( m_alarmChar )
+  }
+
+  // health frame is queued: its window is closed (a frame which has been rolled back is rebuilt with a longer window)
+  if( n && IsHealthDevice( dev ) )
+    NextHealthWindow();
+
+  m_nSymbols    += nCtrl + ( bText ? 34 : 0 );
+  m_sendInterval = bText ? SEND_INTERVAL : SEND_INTERVAL_NOTEXT;
+  return n;
+}
+
+// time-sliced sending, one unit: a symbol of the current window or a step of the next frame. false: nothing to do
+bool JetiExProtocol::SliceStep()
+{
+  if( m_outState == OUT_IDLE )
+  {
+    unsigned long tiDue = m_tiLastSend + m_sendInterval;
+    bool          bDue  = tiDue <= millis();
+    if( !bDue && ( millis() + m_pipeLead ) < tiDue )
+      return false;
+    if( m_buildState != BUILD_DONE )
     {
-      SendJetiAlarm( m_alarmChar );
-      m_alarmChar = 0;
+      uint8_t state = m_buildState;
+      BuildNext();
+      if( state != BUILD_IDLE || m_buildState != BUILD_IDLE )
+        return true;                                 // frame step
     }
-    // EX frame...
-    else if( m_pSensorsConst )
+    if( !bDue )
+      return false;
+
+    // frame is complete (or there is no device): start window, bookkeeping of the EX frame now
+    char    alarm;
+    bool    bExit;
+    uint8_t dev;
+    uint8_t n = NextWindow( dev, alarm, bExit, m_bOutText );
+    m_outN = 0;
+    if( n )
     {
-      SendExFrame( m_frameCnt++ );
+      m_outN      = n + 1;                           // symbols, 0x7E to crc
+      m_nSymbols += n + 1;
+      ExFrameSent( dev, n );
     }
+    m_nOutCtrl = alarm ? BuildAlarm( m_outCtrl, alarm ) : bExit ? BuildExit( m_outCtrl ) : 0;
+    if( m_bOutText )
+    {
+      // text as it is now, SetJetiboxText() may be called between the slices
+      JETIEX_LOCK();
+      if( m_textBuffer[ 0 ] != '\0' )
+        memcpy( m_outText, m_textBuffer, sizeof( m_outText ) );
+      else
+        memset( m_outText, 0, sizeof( m_outText ) );
+      JETIEX_UNLOCK();
+    }
+    m_outState = OUT_EX;
+    m_outPos   = 0;
+    return true;
+  }
 
-    // followed by "simple text" frame
-    SendJetiboxTextFrame();
+  // next part of the window: EX frame, alarm/exit, text frame
+  if( m_outState == OUT_EX && m_outPos >= m_outN )
+  {
+    m_outState = OUT_CTRL;
+    m_outPos   = 0;
+  }
+  if( m_outState == OUT_CTRL && m_outPos >= m_nOutCtrl )
+  {
+    m_outState = OUT_TEXT;
+    m_outPos   = 0;
+  }
+  if( m_outState == OUT_TEXT && ( !m_bOutText || m_outPos >= 34 ) )
+  {
+    m_outState = OUT_IDLE;
+    return SliceStep();
   }
 
-  return 0;
+  // first symbol of a frame without 9th bit
+  uint8_t pos = m_outPos++;
+  if( m_outState == OUT_EX )
+    m_pSerial->Send( m_exBuffer[ pos ], pos != 0 );
+  else if( m_outState == OUT_CTRL )
+    m_pSerial->Send( m_outCtrl[ pos ], pos != 0 );
+  else if( pos == 0 || pos == 33 )
+    m_pSerial->Send( pos == 0 ? 0xFE : 0xFF, false );     // text frame, see SendJetiboxTextFrame()
+  else
+    m_pSerial->Send( m_outText[ pos - 1 ], true );
+  return true;
+}
+
+bool JetiExProtocol::SetJetiAlarm( char alarmChar, uint8_t priority, uint8_t repeat, uint16_t spacingMs )
+{
+  if( alarmChar == 0 || repeat == 0 )
+    return false;
+
+  bool bQueued = true;
+  int  i;
+  JETIEX_LOCK();
+  for( i = 0; i < m_nAlarms && m_alarms[ i ].code != alarmChar; i++ )
+    ;
+  if( i < m_nAlarms )
+  {
+    // merge with identical pending alarm
+    JetiExAlarm * pAlarm = &m_alarms[ i ];
+    if( priority > pAlarm->priority )
+      pAlarm->priority = priority;
+    if( repeat > pAlarm->repeat )
+      pAlarm->repeat = repeat;
+    pAlarm->spacing = spacingMs;
+  }
+  else
+  {
+    // queue full: drop the newest alarm with lowest priority, if it is less important
+    if( m_nAlarms >= MAX_ALARMS )
+    {
+      int low = 0;
+      for( i = 1; i < m_nAlarms; i++ )
+        if( m_alarms[ i ].priority <= m_alarms[ low ].priority )
+          low = i;
+      if( m_alarms[ low ].priority < priority )
+      {
+        memmove( &m_alarms[ low ], &m_alarms[ low + 1 ], ( m_nAlarms - low - 1 ) * sizeof( JetiExAlarm ) );
+        m_nAlarms--;
+      }
+      else
+        bQueued = false;
+    }
+
+    if( bQueued )
+    {
+      JetiExAlarm * pAlarm = &m_alarms[ m_nAlarms++ ];
+      pAlarm->code     = alarmChar;
+      pAlarm->priority = priority;
+      pAlarm->repeat   = repeat;
+      pAlarm->spacing  = spacingMs;
+      pAlarm->tiNext   = millis();
+    }
+  }
+  JETIEX_UNLOCK();
+  return bQueued;
+}
+
+// highest priority alarm which is due (oldest first), 0: none
+char JetiExProtocol::NextAlarm()
+{
+  int next = -1;
+  for( int i = 0; i < m_nAlarms; i++ )
+  {
+    if( (long)( millis() - m_alarms[ i ].tiNext ) >= 0 && ( next < 0 || m_alarms[ i ].priority > m_alarms[ next ].priority ) )
+      next = i;
+  }
+  if( next < 0 )
+    return 0;
+
+  JetiExAlarm * pAlarm = &m_alarms[ next ];
+  char          code   = pAlarm->code;
+  if( --pAlarm->repeat == 0 )
+  {
+    memmove( pAlarm, pAlarm + 1, ( m_nAlarms - next - 1 ) * sizeof( JetiExAlarm ) );
+    m_nAlarms--;
+  }
+  else
+    pAlarm->tiNext = millis() + pAlarm->spacing;
+
+  return code;
+}
+
+// text frame with every frame or on change, after key and keep alive
+bool JetiExProtocol::IsTextFrameDue()
+{
+  if( m_textKeepAlive == 0 )
+    return true;
+
+  if( m_bTextChanged || ( millis() - m_tiLastText ) >= m_textKeepAlive )
+  {
+    m_bTextChanged = false;
+    m_tiLastText   = millis();
+    return true;
+  }
+  return false;
+}
+
+// fair share of link time: the device with the least bytes sent is next, 0xFF: no device with sensors
+// the health device is not part of the fair share, it gets one frame per health interval (dictionary entries included)
+uint8_t JetiExProtocol::NextDevice()
+{
+  if( m_healthDev && ( millis() - m_tiHealth ) >= m_healthInterval )
+  {
+    UpdateHealth();                                  // window is closed when the frame is queued, see NextWindow()
+    return m_healthDev;
+  }
+
+  uint8_t  next   = 0xFF;
+  uint16_t nBytes = 0xFFFF;
+  for( uint8_t dev = 0; dev < m_nDevices; dev++ )
+  {
+    if( IsHealthDevice( dev ) )
+      continue;
+    if( HasSensors( &m_devices[ dev ] ) && m_devices[ dev ].nBytes < nBytes )
+    {
+      next   = dev;
+      nBytes = m_devices[ dev ].nBytes;
+    }
+  }
+
+  // keep counters small
+  if( next != 0xFF )
+    for( uint8_t dev = 0; dev < m_nDevices; dev++ )
+      if( !IsHealthDevice( dev ) && HasSensors( &m_devices[ dev ] ) )
+        m_devices[ dev ].nBytes -= nBytes;
+
+  return next;
+}
+
+// time between two DoJetiSend() calls
+void JetiExProtocol::HealthLoop()
+{
+  unsigned long now = micros();
+  if( m_tiLoop )
+  {
+    unsigned long d = now - m_tiLoop;
+    if( d < m_loopMin )
+      m_loopMin = d;
+    if( d > m_loopMax )
+      m_loopMax = d;
+  }
+  m_tiLoop = now;
+}
+
+// duration of the DoJetiSend() call started in HealthLoop()
+void JetiExProtocol::HealthLoopEnd()
+{
+  unsigned long d = micros() - m_tiLoop;
+  if( d > m_sendMax )
+    m_sendMax = d;
+  m_sendSum += d;
+  m_nSendCalls++;
+}
+
+// close measurement window: health values, set health sensors
+void JetiExProtocol::UpdateHealth()
+{
+  unsigned long windowMs = millis() - m_tiHealth;
+  if( windowMs == 0 )
+    windowMs = 1;
+
+  // values with valid data on the user devices
+  uint16_t nValid = 0;
+  for( uint8_t dev = 0; dev < m_nDevices; dev++ )
+  {
+    JetiExDevice * pDevice = &m_devices[ dev ];
+    if( IsHealthDevice( dev ) || pDevice->pValues == 0 )
+      continue;
+    for( uint8_t idx = 0; idx < pDevice->nSensors; idx++ )
+      if( ( pDevice->valid[ idx >> 3 ] & pDevice->activeSensors[ idx >> 3 ] ) & ( 1 << ( idx & 7 ) ) )
+        nValid++;
+  }
+
+  uint32_t load    = m_nSymbols * ( m_symbolUs / 10 ) / windowMs;                       // % = symbols * us / ( ms * 1000 ) * 100
+  uint32_t refresh = m_nValuesSent ? windowMs * nValid / m_nValuesSent : 0;
+  uint32_t loopMax = m_loopMax;
+  uint32_t jitter  = m_loopMax >= m_loopMin ? m_loopMax - m_loopMin : 0;
+  uint32_t sendMax = m_sendMax;
+  uint32_t sendAvg = m_nSendCalls ? m_sendSum / m_nSendCalls : 0;
+
+  m_health.linkLoad     = load > 100 ? 100 : load;
+  m_health.refreshMs    = refresh > 0xFFFF ? 0xFFFF : refresh;
+  m_health.txHighWater  = m_pSerial ? m_pSerial->TxHighWater() : 0;
+  m_health.txOverflows  = m_pSerial ? m_pSerial->TxOverflows() : 0;
+  m_health.loopJitterUs = jitter > 0xFFFF ? 0xFFFF : jitter;
+  m_health.loopMaxUs    = loopMax > 0xFFFF ? 0xFFFF : loopMax;
+  m_health.sendMaxUs    = sendMax > 0xFFFF ? 0xFFFF : sendMax;
+  m_health.sendMeanUs   = sendAvg > 0xFFFF ? 0xFFFF : sendAvg;
+
+  if( m_healthDev )
+  {
+    SetSensorValue( HEALTH_LINK,     m_health.linkLoad, m_healthDev );
+    SetSensorValue( HEALTH_REFRESH,  m_health.refreshMs > 8191 ? 8191 : m_health.refreshMs, m_healthDev ); // 14 bit
+    SetSensorValue( HEALTH_TXHIGH,   m_health.txHighWater, m_healthDev );
+    SetSensorValue( HEALTH_OVERFLOW, m_health.txOverflows, m_healthDev );
+    SetSensorValue( HEALTH_JITTER,   m_health.loopJitterUs / 100, m_healthDev );
+    SetSensorValue( HEALTH_LOOPMAX,  m_health.loopMaxUs / 100, m_healthDev );
+    SetSensorValue( HEALTH_SENDMAX,  m_health.sendMaxUs > 8191 ? 8191 : m_health.sendMaxUs, m_healthDev );
+  }
+}
+
+// start next measurement window
+void JetiExProtocol::NextHealthWindow()
+{
+  m_tiHealth    = millis();
+  m_nSymbols    = 0;
+  m_nValuesSent = 0;
+  m_loopMin     = 0xFFFFFFFF;
+  m_loopMax     = 0;
+  m_sendMax     = 0;
+  m_sendSum     = 0;
+  m_nSendCalls  = 0;
+}
+
+void JetiExProtocol::GetHealth( Health & health )
+{
+  JETIEX_LOCK();                                     // health frame may be built in timer ISR
+  if( m_healthDev == 0 )
+  {
+    UpdateHealth();
+    NextHealthWindow();
+  }
+  health = m_health;
+  JETIEX_UNLOCK();
+}
+
+void JetiExProtocol::SetSensorValue( uint8_t id, int32_t value, uint8_t dev )
+{
+  if( dev >= m_nDevices )
+    return;
+
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  if( pDevice->pValues && id < sizeof( pDevice->sensorMapper ) )
+  {
+    JETIEX_LOCK();                                   // 32 bit write is not atomic on AVR
+    uint8_t     idx    = pDevice->sensorMapper[ id ];
+    JetiValue * pValue = &pDevice->pValues[ idx ];
+    uint8_t     mask   = 1 << ( idx & 7 );
+    bool        bValid = ( pDevice->valid[ idx >> 3 ] & mask ) != 0;
+    uint8_t     filter = m_nFilters ? pDevice->filter[ idx ] : 0;
+    bool        bFiltered = filter != 0;
+    pDevice->valid[ idx >> 3 ] |= mask;
+    if( pValue->m_timeout )
+      pValue->m_tiUpdate = (uint16_t)millis();
+    if( bFiltered )
+      FilterSample( filter - 1, value );             // filter result and its alarm rules: FilterOutput()
+    else if( !bValid || pValue->m_value != value )
+    {
+      pValue->m_value = value;
+      if( m_nRules )                                 // threshold alarms on change only
+        CheckAlarmRules( dev, id, value );
+    }
+    JETIEX_UNLOCK();
+
+    if( m_pLog )                                     // every value, before filters
+      m_pLog->Value( LogSlot( dev, idx ), value );
+  }
+}
+
+bool JetiExProtocol::SetLog( JetiExLog * pLog )
+{
+  m_pLog = 0;
+  if( pLog == 0 )
+    return true;
+  if( m_devices[ 0 ].nameLen == 0 )                  // after Start() only
+    return false;
+
+  uint16_t nSlots = LogSlot( m_nDevices, 0 );
+  if( !pLog->Begin( nSlots ) )
+    return false;
+
+  // sensor table header: devices and sensors in slot order
+  uint8_t buf[ 8 + JetiSensor::MAX_LABEL ];
+  buf[ 0 ] = m_nDevices;
+  pLog->Header( buf, 1 );
+  for( uint8_t dev = 0; dev < m_nDevices; dev++ )
+  {
+    JetiExDevice * pDevice = &m_devices[ dev ];
+    buf[ 0 ] = pDevice->devIdLow;
+    buf[ 1 ] = pDevice->devIdHi;
+    buf[ 2 ] = pDevice->nameLen;
+    memcpy( buf + 3, pDevice->name, pDevice->nameLen );
+    buf[ 3 + pDevice->nameLen ] = pDevice->nSensors;
+    pLog->Header( buf, 4 + pDevice->nameLen );
+
+    for( uint8_t idx = 0; idx < pDevice->nSensors; idx++ )
+    {
+      JetiSensor sensor( idx, this, dev, true );
+      buf[ 0 ] = SensorId( pDevice, idx );           // not the wire id
+      buf[ 1 ] = sensor.m_dataType;
+      buf[ 2 ] = sensor.m_precision >> 5;
+      buf[ 3 ] = sensor.m_textLen;
+      memcpy_P( buf + 4, sensor.m_pText, sensor.m_textLen );
+      buf[ 4 + sensor.m_textLen ] = sensor.m_unitLen;
+      memcpy_P( buf + 5 + sensor.m_textLen, sensor.m_pUnit, sensor.m_unitLen );
+      pLog->Header( buf, 5 + sensor.m_textLen + sensor.m_unitLen );
+    }
+  }
+
+  m_pLog = pLog;
+  return true;
+}
+
+// index of the sensor in the log header
+uint16_t JetiExProtocol::LogSlot( uint8_t dev, uint8_t idx )
+{
+  uint16_t slot = idx;
+  for( uint8_t d = 0; d < dev; d++ )
+    slot += m_devices[ d ].nSensors;
+  return slot;
+}
+
+void JetiExProtocol::SetSensorTimeout( uint8_t id, uint16_t timeoutMs, uint8_t dev )
+{
+  if( dev >= m_nDevices || id >= sizeof( m_devices[ dev ].sensorMapper ) )
+    return;
+
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  if( pDevice->pValues == 0 )
+    return;
+
+  uint16_t tiNow = (uint16_t)millis();
+  JETIEX_LOCK();
+  for( uint8_t idx = 0; idx < pDevice->nSensors; idx++ )
+  {
+    if( id == 0 || pDevice->sensorMapper[ id ] == idx )
+    {
+      pDevice->pValues[ idx ].m_timeout  = timeoutMs;
+      pDevice->pValues[ idx ].m_tiUpdate = tiNow;   // current values expire timeoutMs from now
+    }
+  }
+  JETIEX_UNLOCK();
+}
+
+void JetiExProtocol::SetSensorValueInvalid( uint8_t id, uint8_t dev )
+{
+  if( dev >= m_nDevices || id >= sizeof( m_devices[ dev ].sensorMapper ) )
+    return;
+
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  JETIEX_LOCK();
+  uint8_t idx = pDevice->sensorMapper[ id ];
+  pDevice->valid[ idx >> 3 ] &= ~( 1 << ( idx & 7 ) );
+  if( m_nFilters && pDevice->filter[ idx ] )
+    FilterReset( pDevice->filter[ idx ] - 1 );       // don't continue with old samples
+  JETIEX_UNLOCK();
+}
+
+bool JetiExProtocol::IsSensorValueValid( uint8_t id, uint8_t dev )
+{
+  if( dev >= m_nDevices || id >= sizeof( m_devices[ dev ].sensorMapper ) || m_devices[ dev ].pValues == 0 )
+    return false;
+
+  JETIEX_LOCK();
+  bool bValid = CheckValid( &m_devices[ dev ], m_devices[ dev ].sensorMapper[ id ] );
+  JETIEX_UNLOCK();
+  return bValid;
+}
+
+// value has been set and is not expired, an expired value is invalidated
+bool JetiExProtocol::CheckValid( JetiExDevice * pDevice, uint8_t idx )
+{
+  uint8_t mask = 1 << ( idx & 7 );
+  if( ( pDevice->valid[ idx >> 3 ] & mask ) == 0 )
+    return false;
+
+  JetiValue * pValue = &pDevice->pValues[ idx ];
+  if( pValue->m_timeout && (uint16_t)( (uint16_t)millis() - pValue->m_tiUpdate ) >= pValue->m_timeout )
+  {
+    pDevice->valid[ idx >> 3 ] &= ~mask;
+    return false;
+  }
+  return true;
+}
+
+// one value per call: an expiry is found before the 16 bit time stamp wraps, IsSensorValueValid() relies on the valid bit
+void JetiExProtocol::CheckNextTimeout()
+{
+  JetiExDevice * pDevice = &m_devices[ m_timeoutDev ];
+  if( m_timeoutIdx < pDevice->nSensors && pDevice->pValues )
+    CheckValid( pDevice, m_timeoutIdx );
+  if( ++m_timeoutIdx >= pDevice->nSensors )
+  {
+    m_timeoutIdx = 0;
+    if( ++m_timeoutDev >= m_nDevices )
+      m_timeoutDev = 0;
+  }
+}
+
+bool JetiExProtocol::SetSensorFilters( JETISENSORFILTER_CONST * pFilters )
+{
+  uint8_t dev, n = 0;
+  while( pFilters && n < MAX_FILTERS && pgm_read_byte( &pFilters[ n ].id ) != 0 )
+    n++;
+
+  {
+    JETIEX_LOCK();
+    for( dev = 0; dev < m_nDevices; dev++ )
+      memset( m_devices[ dev ].filter, 0, sizeof( m_devices[ dev ].filter ) );
+    m_nFilters       = 0;
+    m_filtersInFrame = 0;
+    JETIEX_UNLOCK();
+  }
+
+  delete [] m_pFilters;
+  m_pFilters = 0;
+  if( n == 0 )
+    return true;
+  if( m_devices[ 0 ].pValues == 0 || ( m_pFilters = new JetiExFilter[ n ] ) == 0 )
+    return false;
+
+  uint8_t nFilters = 0;
+  for( uint8_t i = 0; i < n; i++ )
+  {
+    JetiSensorFilter filter;
+    memcpy_P( &filter, &pFilters[ i ], sizeof( filter ) );
+    if( filter.dev >= m_nDevices )
+      continue;
+
+    // unknown ids map to index 0, EMA weight 1/2..1/256
+    JetiExDevice * pDevice = &m_devices[ filter.dev ];
+    if( pDevice->nSensors == 0 || filter.id >= sizeof( pDevice->sensorMapper ) )
+      continue;
+    uint8_t idx = pDevice->sensorMapper[ filter.id ];
+    if( SensorId( pDevice, idx ) != filter.id || pDevice->filter[ idx ] != 0 )
+      continue;
+    if( filter.type < FILTER_EMA || filter.type > FILTER_MAX || ( filter.type == FILTER_EMA && ( filter.param < 1 || filter.param > 8 ) ) )
+      continue;
+
+    JetiExFilter * pFilter = &m_pFilters[ nFilters++ ];
+    memset( pFilter, 0, sizeof( JetiExFilter ) );
+    pFilter->dev      = filter.dev;
+    pFilter->idx      = idx;
+    pFilter->type     = filter.type;
+    pFilter->param    = filter.param;
+    pFilter->decimate = filter.decimate;
+    pDevice->filter[ idx ] = nFilters;               // index + 1
+  }
+
+  JETIEX_LOCK();
+  m_nFilters = nFilters;
+  JETIEX_UNLOCK();
+  return true;
 }
 
-void JetiExProtocol::SetSensorValue( uint8_t id, int32_t value )
+// O(1) per sample, i: filter index from JetiExDevice::filter
+void JetiExProtocol::FilterSample( uint8_t i, int32_t value )
 {
-  if( m_pValues && id < sizeof( m_sensorMapper ) )
-    m_pValues[ m_sensorMapper[ id ] ].m_value = value;
+  JetiExFilter * pFilter = &m_pFilters[ i ];
+  if( pFilter->decimate > 1 )
+  {
+    if( pFilter->decimCnt++ != 0 )
+    {
+      if( pFilter->decimCnt >= pFilter->decimate )
+        pFilter->decimCnt = 0;
+      return;
+    }
+  }
+
+
+  switch( pFilter->type )
+  {
+  case FILTER_EMA:
+    if( pFilter->count == 0 )
+      pFilter->acc = value * ( (int32_t)1 << pFilter->param );
+    else
+      pFilter->acc += value - ( pFilter->acc >> pFilter->param );
+    pFilter->count = 1;
+    break;
+  case FILTER_AVG:
+    if( pFilter->count == 0 )
+      pFilter->acc = 0;
+    if( pFilter->count < 0xFFFF )
+    {
+      pFilter->acc += value;
+      pFilter->count++;
+    }
+    break;
+  case FILTER_MIN:
+    if( pFilter->count == 0 || value < pFilter->acc )
+      pFilter->acc = value;
+    pFilter->count = 1;
+    break;
+  case FILTER_MAX:
+    if( pFilter->count == 0 || value > pFilter->acc )
+      pFilter->acc = value;
+    pFilter->count = 1;
+    break;
+  }
 }
 
-void JetiExProtocol::SetSensorValueGPS( uint8_t id, bool bLongitude, float value )
+// filter result to value array before it is encoded, alarm rules are evaluated on it. FILTER_AVG/MIN/MAX start again now,
+// samples which arrive until the frame is sent (frame pipeline) go to the next result. No sample: last result is held
+void JetiExProtocol::FilterOutput( uint8_t i )
+{
+  JetiExFilter * pFilter = &m_pFilters[ i ];
+  if( pFilter->count )
+  {
+    int32_t value = pFilter->acc;
+    if( pFilter->type == FILTER_EMA )
+      value = pFilter->acc >> pFilter->param;
+    else if( pFilter->type == FILTER_AVG )
+      value = pFilter->acc / (int32_t)pFilter->count;
+    JetiExDevice * pDevice = &m_devices[ pFilter->dev ];
+    pDevice->pValues[ pFilter->idx ].m_value = value;
+    if( m_nRules )                                   // threshold alarms on the filtered value
+    {
+      JETIEX_LOCK();
+      CheckAlarmRules( pFilter->dev, SensorId( pDevice, pFilter->idx ), value );
+      JETIEX_UNLOCK();
+    }
+    if( pFilter->type != FILTER_EMA )
+    {
+      pFilter->outAcc   = pFilter->acc;              // for RestoreFilters()
+      pFilter->outCount = pFilter->count;
+      pFilter->count    = 0;
+      m_filtersInFrame |= 1 << i;
+    }
+  }
+}
+
+// EX frame is not sent: samples of the results in the frame go to the next result
+void JetiExProtocol::RestoreFilters()
+{
+  for( uint8_t i = 0; m_filtersInFrame; i++, m_filtersInFrame >>= 1 )
+  {
+    if( !( m_filtersInFrame & 1 ) )
+      continue;
+
+    JetiExFilter * pFilter = &m_pFilters[ i ];
+    if( pFilter->count == 0 )
+    {
+      pFilter->acc   = pFilter->outAcc;
+      pFilter->count = pFilter->outCount;
+    }
+    else if( pFilter->type == FILTER_AVG && (uint32_t)pFilter->count + pFilter->outCount <= 0xFFFF )
+    {
+      pFilter->acc   += pFilter->outAcc;
+      pFilter->count += pFilter->outCount;
+    }
+    else if( ( pFilter->type == FILTER_MIN && pFilter->outAcc < pFilter->acc ) ||
+             ( pFilter->type == FILTER_MAX && pFilter->outAcc > pFilter->acc ) )
+      pFilter->acc = pFilter->outAcc;
+    pFilter->outCount = 0;
+  }
+}
+
+void JetiExProtocol::FilterReset( uint8_t i )
+{
+  m_pFilters[ i ].count    = 0;
+  m_pFilters[ i ].outCount = 0;
+  m_pFilters[ i ].decimCnt = 0;
+}
+
+void JetiExProtocol::SetAlarmRules( JETIALARMRULE_CONST * pRules )
+{
+  JETIEX_LOCK();
+  m_pRules       = pRules;
+  m_nRules       = 0;
+  m_rulesPending = 0;
+  memset( m_ruleState, RULE_IDLE, sizeof( m_ruleState ) );
+  while( m_pRules && m_nRules < MAX_ALARM_RULES && pgm_read_byte( &m_pRules[ m_nRules ].id ) != 0 )
+    m_nRules++;
+  JETIEX_UNLOCK();
+}
+
+void JetiExProtocol::CheckAlarmRules( uint8_t dev, uint8_t id, int32_t value )
+{
+  for( uint8_t i = 0; i < m_nRules; i++ )
+  {
+    if( pgm_read_byte( &m_pRules[ i ].id ) != id )
+      continue;
+
+    JetiAlarmRule rule;
+    memcpy_P( &rule, &m_pRules[ i ], sizeof( rule ) );
+    if( rule.dev != dev )
+      continue;
+
+    // active alarm ends with hysteresis
+    int32_t hyst = m_ruleState[ i ] == RULE_ACTIVE ? rule.hysteresis : 0;
+    bool    bLimit = ( rule.low  != JETI_NO_LIMIT && value < rule.low  + hyst ) ||
+                     ( rule.high != JETI_NO_LIMIT && value > rule.high - hyst );
+    if( !bLimit )
+    {
+      m_ruleState[ i ] = RULE_IDLE;
+      m_rulesPending  &= ~( 1 << i );
+    }
+    else if( m_ruleState[ i ] == RULE_IDLE )
+    {
+      if( rule.debounceMs == 0 )
+      {
+        m_ruleState[ i ] = RULE_ACTIVE;
+        SetJetiAlarm( rule.alarmChar, rule.priority, rule.repeat ? rule.repeat : 1, rule.spacingMs );
+      }
+      else
+      {
+        m_ruleState[ i ] = RULE_PENDING;
+        m_tiRule[ i ]    = (uint16_t)millis();
+        m_rulesPending  |= 1 << i;
+      }
+    }
+  }
+}
+
+// limit exceeded for debounce time: raise alarm
+void JetiExProtocol::CheckPendingRules()
+{
+  JETIEX_LOCK();
+  for( uint8_t i = 0; i < m_nRules; i++ )
+  {
+    if( ( m_rulesPending & ( 1 << i ) ) == 0 )
+      continue;
+
+    JetiAlarmRule rule;
+    memcpy_P( &rule, &m_pRules[ i ], sizeof( rule ) );
+    if( (uint16_t)( (uint16_t)millis() - m_tiRule[ i ] ) >= rule.debounceMs )
+    {
+      m_ruleState[ i ] = RULE_ACTIVE;
+      m_rulesPending  &= ~( 1 << i );
+      SetJetiAlarm( rule.alarmChar, rule.priority, rule.repeat ? rule.repeat : 1, rule.spacingMs );
+    }
+  }
+  JETIEX_UNLOCK();
+}
+
+void JetiExProtocol::SetSensorValueGPS( uint8_t id, bool bLongitude, float value, uint8_t dev )
 {
   // Jeti doc: If the lowest bit of a decimal point (Bit 5) equals log. 1, the data represents longitude. According to the highest bit (30) of a decimal point it is either West (1) or East (0).
   // Jeti doc: If the lowest bit of a decimal point (Bit 5) equals log. 0, the data represents latitude. According to the highest bit (30) of a decimal point it is either South (1) or North (0).
@@ -236,10 +1311,10 @@ void JetiExProtocol::SetSensorValueGPS( uint8_t id, bool bLongitude, float value
   gps.vBytes[3] |= bLongitude  ? 0x20 : 0;
   gps.vBytes[3] |= (value < 0) ? 0x40 : 0;
   
-  SetSensorValue( id, gps.vInt );
+  SetSensorValue( id, gps.vInt, dev );
 }
 
-void JetiExProtocol::SetSensorValueDate( uint8_t id, uint8_t day, uint8_t month, uint16_t year )
+void JetiExProtocol::SetSensorValueDate( uint8_t id, uint8_t day, uint8_t month, uint16_t year, uint8_t dev )
 {
   // Jeti doc: If the lowest bit of a decimal point equals log. 1, the data represents date
   // Jeti doc: (decimal representation: b0-7 day, b8-15 month, b16-20 year - 2 decimals, number 2000 to be added).
@@ -259,10 +1334,10 @@ void JetiExProtocol::SetSensorValueDate( uint8_t id, uint8_t day, uint8_t month,
   date.vBytes[2]  = day & 0x1F;
   date.vBytes[2] |= 0x20;
   
-  SetSensorValue( id, date.vInt );
+  SetSensorValue( id, date.vInt, dev );
 }
 
-void JetiExProtocol::SetSensorValueTime( uint8_t id, uint8_t hour, uint8_t minute, uint8_t second )
+void JetiExProtocol::SetSensorValueTime( uint8_t id, uint8_t hour, uint8_t minute, uint8_t second, uint8_t dev )
 {
   // If the lowest bit of a decimal point equals log. 0, the data represents time
   // (decimal representation: b0-7 seconds, b8-15 minutes, b16-20 hours).
@@ -277,48 +1352,139 @@ void JetiExProtocol::SetSensorValueTime( uint8_t id, uint8_t hour, uint8_t minut
   date.vBytes[1]  = minute;
   date.vBytes[2]  = hour & 0x1F;
   
-  SetSensorValue( id, date.vInt );
+  SetSensorValue( id, date.vInt, dev );
 }
 
-void JetiExProtocol::SetSensorActive( uint8_t id, bool bEnable, JETISENSOR_CONST * pSensorArray )
+void JetiExProtocol::SetSensorActive( uint8_t id, bool bEnable, JETISENSOR_CONST * pSensorArray, uint8_t dev )
 {
-  if( m_nSensors == 0 && pSensorArray ) // dont do it more than once
-    InitSensorMapper( pSensorArray );
+  if( dev >= m_nDevices )
+    return;
 
-  if( id < sizeof( m_sensorMapper ) )
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  if( pDevice->nSensors == 0 && pSensorArray ) // dont do it more than once
+    InitSensorMapper( dev, pSensorArray );
+
+  JETIEX_LOCK();
+  if( id < sizeof( pDevice->sensorMapper ) )
   {
-    int idx = m_sensorMapper[ id ];
+    int     idx  = pDevice->sensorMapper[ id ];
+    uint8_t mask = 1 << (idx & 7);
+    bool    bWasActive = ( pDevice->activeSensors[ idx >>3 ] & mask ) != 0;
     if( bEnable )
-      m_activeSensors[ idx >>3 ] |=   1 << (idx & 7);
+      pDevice->activeSensors[ idx >>3 ] |=  mask;
     else
-      m_activeSensors[ idx >>3 ] &= ~(1 << (idx & 7));
+      pDevice->activeSensors[ idx >>3 ] &= ~mask;
+
+    // dictionary entry of a newly activated sensor is sent between value frames
+    if( bEnable && !bWasActive )
+      SetDictPending( pDevice, idx, true );
+    else if( !bEnable )
+      SetDictPending( pDevice, idx, false );
   }
+  JETIEX_UNLOCK();
+}
+
+void JetiExProtocol::RequestDictionary( uint8_t dev )
+{
+  if( dev >= m_nDevices )
+    return;
 
-  // restart sending dictionary
-  m_sensorIdx = m_dictIdx = m_frameCnt = 0;
+  JETIEX_LOCK();
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  pDevice->frameCnt   = pDevice->dictIdx = 0;
+  pDevice->dictState &= ~DICT_DONE;
+  JETIEX_UNLOCK();
 }
 
-void JetiExProtocol::InitSensorMapper( JETISENSOR_CONST * pSensorArray )
+uint8_t JetiExProtocol::GetValueFrameRatio()
+{
+  JETIEX_LOCK();
+  uint32_t nValue = m_nValueFrames, nDict = m_nDictFrames;
+  JETIEX_UNLOCK();
+
+  // scale both counters down so that nValue * 100 and the sum stay in 32 bits (no 64 bit division on AVR)
+  while( nValue > 0xFFFFFFFFUL / 200 || nDict > 0xFFFFFFFFUL / 200 )
+  {
+    nValue >>= 1;
+    nDict  >>= 1;
+  }
+  uint32_t nTotal = nValue + nDict;
+  return nTotal ? (uint8_t)( ( nValue * 100 ) / nTotal ) : 0;
+}
+
+void JetiExProtocol::SetDictPending( JetiExDevice * pDevice, uint8_t idx, bool bPending )
+{
+  uint8_t mask     = 1 << (idx & 7);
+  bool    bPrevious = ( pDevice->dictPending[ idx >> 3 ] & mask ) != 0;
+  if( bPending && !bPrevious )
+  {
+    pDevice->dictPending[ idx >> 3 ] |= mask;
+    pDevice->nDictPending++;
+  }
+  else if( !bPending && bPrevious )
+  {
+    pDevice->dictPending[ idx >> 3 ] &= ~mask;
+    pDevice->nDictPending--;
+  }
+}
+
+void JetiExProtocol::InitSensorMapper( uint8_t dev, JETISENSOR_CONST * pSensorArray, JETISENSOR_PACKED * pPacked, const char * pPool )
 { 
   // map sensor id to index to give quick access by sensor ID
+  JetiExDevice * pDevice = &m_devices[ dev ];
   int i;
-  m_nSensors = 0;
-  m_pSensorsConst = pSensorArray;
-  memset( m_sensorMapper, 0, sizeof( m_sensorMapper ) );
-  for( i = 0; i < MAX_SENSORS; i++ )
+  pDevice->nSensors = 0;
+  pDevice->pSensorsConst  = pSensorArray;
+  pDevice->pSensorsPacked = pPool ? pPacked : 0;
+  pDevice->pPool          = pPool;
+  memset( pDevice->sensorMapper, 0, sizeof( pDevice->sensorMapper ) );
+  for( i = 0; HasSensors( pDevice ) && i < MAX_SENSORS; i++ )
   {
     // get sensor id and check for end of array
-    JetiSensorConst sensorConst;
-    memcpy_P( &sensorConst, &m_pSensorsConst[i], sizeof(sensorConst) );
-    if( sensorConst.id == 0 )
+    uint8_t id = SensorId( pDevice, i );
+    if( id == 0 )
       break;
 
-    if( sensorConst.id < sizeof( m_sensorMapper ) )
-      m_sensorMapper[ sensorConst.id ] = i;
-    m_nSensors++;
+    if( id < sizeof( pDevice->sensorMapper ) )
+      pDevice->sensorMapper[ id ] = i;
+    pDevice->nSensors++;
   }
 }
 
+uint8_t JetiExProtocol::SensorId( const JetiExDevice * pDevice, uint8_t idx )
+{
+  return pgm_read_byte( pDevice->pSensorsPacked ? &pDevice->pSensorsPacked[ idx ].id : &pDevice->pSensorsConst[ idx ].id );
+}
+
+// wire ids 1..n: fast sensors from SetIdRemap(), then active and inactive sensors in table order
+void JetiExProtocol::InitWireIds( uint8_t dev )
+{
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  uint8_t        wireId  = 1;
+  uint8_t        idx;
+  pDevice->pWireIds = new uint8_t[ pDevice->nSensors ];
+  memset( pDevice->pWireIds, 0, pDevice->nSensors );
+
+  for( const uint8_t * pId = pDevice->pFastIds; *pId; pId++ )
+  {
+    if( *pId >= sizeof( pDevice->sensorMapper ) )
+      continue;
+    idx = pDevice->sensorMapper[ *pId ];
+    if( SensorId( pDevice, idx ) == *pId && pDevice->pWireIds[ idx ] == 0 )
+      pDevice->pWireIds[ idx ] = wireId++;
+  }
+  for( uint8_t pass = 0; pass < 2; pass++ )         // active sensors first
+  {
+    for( idx = 0; idx < pDevice->nSensors; idx++ )
+    {
+      bool bActive = ( pDevice->activeSensors[ idx >> 3 ] & ( 1 << ( idx & 7 ) ) ) != 0;
+      if( pDevice->pWireIds[ idx ] == 0 && bActive == ( pass == 0 ) )
+        pDevice->pWireIds[ idx ] = wireId++;
+    }
+  }
+  pDevice->pFastIds = 0;
+}
+
 void JetiExProtocol::SetJetiboxText( enLineNo lineNo, const char* text )
 {
   if( text == 0 )
@@ -333,16 +1499,20 @@ void JetiExProtocol::SetJetiboxText( enLineNo lineNo, const char* text )
   }
   
   bool bPadding = false;
+  JETIEX_LOCK();                                     // don't send half updated lines in timer mode
   for( int i = 0; i < 16; i++ )
   {
     if( text[ i ] == '\0' )
       bPadding = true;
 
-    if( !bPadding )
-      pStart[ i ] = text[ i ];
-    else
-      pStart[ i ] = ' ';
+    char c = bPadding ? ' ' : text[ i ];
+    if( pStart[ i ] != c )
+    {
+      pStart[ i ]    = c;
+      m_bTextChanged = true;
+    }
   }
+  JETIEX_UNLOCK();
 }
 
 void JetiExProtocol::SendJetiboxTextFrame()
@@ -367,12 +1537,32 @@ void JetiExProtocol::SendJetiboxTextFrame()
 
 void JetiExProtocol::SendJetiboxExit()
 {
-  m_pSerial->Send( 0x7E, false );
-  m_pSerial->Send( 0x91, true );
-  m_pSerial->Send( 0x31, true );
+  uint8_t frame[ 3 ];
+  SendCtrl( frame, BuildExit( frame ) );
+}
+
+uint8_t JetiExProtocol::BuildExit( uint8_t * pFrame )
+{
+  pFrame[ 0 ] = 0x7E;
+  pFrame[ 1 ] = 0x91;
+  pFrame[ 2 ] = 0x31;
+  return 3;
+}
+
+// alarm or exit frame, first symbol without 9th bit
+void JetiExProtocol::SendCtrl( const uint8_t * pFrame, uint8_t n )
+{
+  for( uint8_t i = 0; i < n; i++ )
+    m_pSerial->Send( pFrame[ i ], i != 0 );
 }
 
-void JetiExProtocol::SendJetiAlarm( char code ) // upper case character produces sound, lower case is silent
+void JetiExProtocol::SendJetiAlarm( char code )
+{
+  uint8_t frame[ 4 ];
+  SendCtrl( frame, BuildAlarm( frame, code ) );
+}
+
+uint8_t JetiExProtocol::BuildAlarm( uint8_t * pFrame, char code ) // upper case character produces sound, lower case is silent
 {
   bool bSound = true;
   if( islower( code ) )
@@ -381,42 +1571,97 @@ void JetiExProtocol::SendJetiAlarm( char code ) // upper case character produces
     bSound = false;
   }
 
-  m_pSerial->Send( 0x7E, false );                      
-  m_pSerial->Send( 0x02, true );                         // length
-  m_pSerial->Send( 0x22 | (bSound ? 0x01 : 0x00), true); // alarm type "vario" w/o sound or "normal"
-  m_pSerial->Send( code, true );                         // send "morse code" character
+  pFrame[ 0 ] = 0x7E;
+  pFrame[ 1 ] = 0x02;                                    // length
+  pFrame[ 2 ] = 0x22 | (bSound ? 0x01 : 0x00);           // alarm type "vario" w/o sound or "normal"
+  pFrame[ 3 ] = code;                                    // send "morse code" character
+  return 4;
+}
+
+
+void JetiExProtocol::SendExFrame( uint8_t dev, uint8_t frameCnt )
+{
+  SendExBuffer( dev, BuildExFrame( dev, frameCnt ) );
 }
 
+// assemble EX frame in one go, returns position of crc in m_exBuffer
+uint8_t JetiExProtocol::BuildExFrame( uint8_t dev, uint8_t frameCnt )
+{
+  BuildBegin( dev, frameCnt );
+  while( !BuildStep() )
+    ;
+  SwapFrame();                                                     // frame pipeline: second buffer
+  return m_buildN;
+}
 
-void JetiExProtocol::SendExFrame( uint8_t frameCnt )
+// start EX frame in m_pBuild: dictionary entries are complete, values are added by BuildStep()
+void JetiExProtocol::BuildBegin( uint8_t dev, uint8_t frameCnt )
 {
+  JetiExDevice * pDevice = &m_devices[ dev ];
   uint8_t n = 0;
-  uint8_t i = 0;
+  m_filtersInFrame = 0;
+  m_valuesInFrame  = 0;
+  m_buildDev       = dev;
+
+  // startup dictionary phase in the first frames, repeated on frame counter wrap in DICT_REFRESH_WRAP mode
+  // the health device trickles instead: a full dictionary every 256 frames would take it ~16 health intervals
+  bool bHealth    = IsHealthDevice( dev );
+  bool bDictPhase = (frameCnt/2) <= pDevice->nSensors && ( ( m_dictRefresh == DICT_REFRESH_WRAP && !bHealth ) || !( pDevice->dictState & DICT_DONE ) );
+  if( (frameCnt/2) > pDevice->nSensors )
+    pDevice->dictState |= DICT_DONE;
+
+  // one dictionary entry every m_dictTrickle frames
+  bool bTrickle = false;
+  if( !bDictPhase && ( m_dictRefresh == DICT_REFRESH_TRICKLE || ( m_dictRefresh == DICT_REFRESH_WRAP && bHealth ) ) && ++pDevice->trickleCnt > m_dictTrickle )
+  {
+    pDevice->trickleCnt = 0;
+    bTrickle = true;
+  }
 
   // sensor name in frame 0
-  if( frameCnt == 0 )
+  if( ( bDictPhase && frameCnt == 0 ) || ( bTrickle && ( pDevice->dictState & DICT_NAME ) ) )
   {                                                                // sensor name
-    m_exBuffer[2] = 0x00;  			                                   // 2Bit packet type(0-3) 0x40=Data, 0x00=Text 
-    m_exBuffer[8] = 0x00;                                          // 8Bit id 
-    m_exBuffer[9] = m_nameLen<<3;                                  // 5Bit description, 3Bit unit length (use one space character)
-    memcpy( m_exBuffer + 10, m_name, m_nameLen );                  // copy label plus unit to ex buffer starting from pos 10
-    n += m_nameLen + 10;                                          
+    m_pBuild[2] = 0x00;  			                                   // 2Bit packet type(0-3) 0x40=Data, 0x00=Text 
+    m_pBuild[8] = 0x00;                                          // 8Bit id 
+    m_pBuild[9] = pDevice->nameLen<<3;                           // 5Bit description, 3Bit unit length (use one space character)
+    memcpy( m_pBuild + 10, pDevice->name, pDevice->nameLen );    // copy label plus unit to ex buffer starting from pos 10
+    n += pDevice->nameLen + 10;                                          
+    pDevice->dictState &= ~DICT_NAME;
+  }
+  // changed dictionary entries (SetSensorActive()): every other frame
+  else if( pDevice->nDictPending && (frameCnt % 2) == 0 )
+  {
+    for( uint8_t idx = 0; idx < pDevice->nSensors; idx++ )
+    {
+      if( pDevice->dictPending[ idx >> 3 ] & ( 1 << (idx & 7) ) )
+      {
+        JetiSensor sensor( idx, this, dev, true );
+        m_pBuild[2] = 0x00;
+        m_pBuild[8] = sensor.m_id;
+        m_pBuild[9] = (sensor.m_textLen<<3) | sensor.m_unitLen;
+        n = sensor.jetiCopyLabel( m_pBuild, 10 ) + 10;
+        break;                                                     // pending bit is reset in SendExBuffer()
+      }
+    }
   }
   // sensor dictionary: use the first few frames with even numbers to transfer 
-  else if( ( (frameCnt/2) <= m_nSensors && (frameCnt % 2) == 0 ) )
+  else if( ( bDictPhase && (frameCnt % 2) == 0 ) || bTrickle )
   {
-    for( int nDict = 0; nDict < m_nSensors; nDict++ )
+    for( int nDict = 0; nDict < pDevice->nSensors; nDict++ )
     {
-      JetiSensor sensor( m_dictIdx, this );
-      if( ++m_dictIdx >= m_nSensors )
-        m_dictIdx = 0;
+      JetiSensor sensor( pDevice->dictIdx, this, dev, true );
+      if( ++pDevice->dictIdx >= pDevice->nSensors )
+      {
+        pDevice->dictIdx    = 0;
+        pDevice->dictState |= DICT_NAME;                           // trickle mode: name before first sensor
+      }
 
       if( sensor.m_bActive )
       {
-        m_exBuffer[2] = 0x00;                                          // 2Bit packet type(0-3) 0x40=Data, 0x00=Text
-        m_exBuffer[8] = sensor.m_id;  	                               // 8Bit id
-        m_exBuffer[9] = (sensor.m_textLen<<3) | sensor.m_unitLen;	     // 5Bit description, 3Bit unit length 
-        n = sensor.jetiCopyLabel( m_exBuffer, 10 ) + 10;               // copy label plus unit to ex buffer starting from pos 10
+        m_pBuild[2] = 0x00;                                          // 2Bit packet type(0-3) 0x40=Data, 0x00=Text
+        m_pBuild[8] = sensor.m_id;  	                               // 8Bit id
+        m_pBuild[9] = (sensor.m_textLen<<3) | sensor.m_unitLen;	     // 5Bit description, 3Bit unit length 
+        n = sensor.jetiCopyLabel( m_pBuild, 10 ) + 10;               // copy label plus unit to ex buffer starting from pos 10
         break;
       }
     }
@@ -424,74 +1669,160 @@ void JetiExProtocol::SendExFrame( uint8_t frameCnt )
   // send EX values in all other frames
   else
   {
-    int bufLen;
-    int nVal = 0;                                                  // count values 
-    m_exBuffer[ 2 ] = 0x40;						                             // 2Bit Type(0-3) 0x40=Data, 0x00=Text
-    n=8;						                                               // start at nineth byte in buffer
+    m_pBuild[ 2 ] = 0x40;                                          // 2Bit Type(0-3) 0x40=Data, 0x00=Text
+    m_buildN      = 8;                                             // start at nineth byte in buffer
+    m_buildVal    = 0;                                             // count values
+    m_buildState  = BUILD_VALUES;
+    return;
+  }
 
-    do
-    {
-      bufLen = 0;                                                           // last value buffer length    
-      JetiSensor sensor( m_sensorIdx, this );
-      if( ++m_sensorIdx >= m_nSensors )                                     // wrap index when array is at the end
-        m_sensorIdx = 0;
+  m_buildN = n;
+  BuildEnd();
+}
+
+// next sensor of a value frame, true: frame is complete
+bool JetiExProtocol::BuildStep()
+{
+  if( m_buildState != BUILD_VALUES )
+    return m_buildState == BUILD_DONE;
+
+  JetiExDevice * pDevice = &m_devices[ m_buildDev ];
+  uint8_t        n       = m_buildN;
+  int            bufLen  = 0;                                             // last value buffer length
+  uint8_t        idx     = pDevice->sensorIdx;
+  if( ++pDevice->sensorIdx >= pDevice->nSensors )                         // wrap index when array is at the end
+    pDevice->sensorIdx = 0;
+
+  if( CheckValid( pDevice, idx ) )                                        // not set yet or expired: no space in frame
+  {
+    if( m_nFilters && pDevice->filter[ idx ] )
+      FilterOutput( pDevice->filter[ idx ] - 1 );
+    JetiSensor sensor( idx, this, m_buildDev );
 
-      if( sensor.m_bActive && sensor.m_value != -1 )                        // -1 is "invalid"
+    if( sensor.m_bActive )
+    {
+      if( sensor.m_id > 15 )
       {
-	      if( sensor.m_id > 15 )
-		    {
-		      m_exBuffer[n++] = 0x0 | (sensor.m_dataType & 0x0F);               // sensor id > 15 --> put id to next byte
-		      m_exBuffer[n++] = sensor.m_id;		
-		    }
-		    else
-		      m_exBuffer[n++] = (sensor.m_id<<4) | (sensor.m_dataType & 0x0F);  // 4Bit id, 4 bit data type (i.e. int14_t)
-			
-        bufLen = sensor.m_bufLen;
-        n += sensor.jetiEncodeValue( m_exBuffer, n );
+        m_pBuild[n++] = 0x0 | (sensor.m_dataType & 0x0F);                 // sensor id > 15 --> put id to next byte
+        m_pBuild[n++] = sensor.m_id;
       }
-      if( ++nVal >= m_nSensors )                                            // dont send twice in a frame
-        break;
+      else
+        m_pBuild[n++] = (sensor.m_id<<4) | (sensor.m_dataType & 0x0F);    // 4Bit id, 4 bit data type (i.e. int14_t)
+
+      bufLen = sensor.m_bufLen;
+      n += sensor.jetiEncodeValue( m_pBuild, n );
+      if( !IsHealthDevice( m_buildDev ) )
+        m_valuesInFrame++;
     }
-    while( n < ( 26 - bufLen ) );                                           // jeti spec says max 29 Bytes per buffer
   }
+  m_buildN = n;
+
+  // dont send twice in a frame, jeti spec says max 29 Bytes per buffer
+  if( ++m_buildVal >= pDevice->nSensors || n >= ( 26 - bufLen ) )
+  {
+    BuildEnd();
+    return true;
+  }
+  return false;
+}
+
+// header and crc
+void JetiExProtocol::BuildEnd()
+{
+  JetiExDevice * pDevice = &m_devices[ m_buildDev ];
+  uint8_t        n       = m_buildN;
 
   // complete some more EX frame data
-  m_exBuffer[0] = 0x7E;                m_exBuffer[1] = 0x2F;			          // EX-Frame Separator
-  m_exBuffer[2] |= n-2;					                                            // frame length to Byte 2
-  m_exBuffer[3] = MANUFACTURER_ID_LOW; m_exBuffer[4] = MANUFACTURER_ID_HI;  // sensor ID
-  m_exBuffer[5] = m_devIdLow;          m_exBuffer[6] = m_devIdHi;
-  m_exBuffer[7] = 0x00; // reserved (key for encryption)
+  m_pBuild[0] = 0x7E;                m_pBuild[1] = 0x2F;			          // EX-Frame Separator
+  m_pBuild[2] |= n-2;					                                            // frame length to Byte 2
+  m_pBuild[3] = MANUFACTURER_ID_LOW; m_pBuild[4] = MANUFACTURER_ID_HI;  // sensor ID
+  m_pBuild[5] = pDevice->devIdLow;   m_pBuild[6] = pDevice->devIdHi;
+  m_pBuild[7] = 0x00; // reserved (key for encryption)
 
   // calculate crc
-  m_exBuffer[n] = jeti_crc8( m_exBuffer, n );
+  m_pBuild[n] = jeti_crc8( m_pBuild, n );
+  m_buildState = BUILD_DONE;
+}
+
+// frame pipeline: next step of the frame for the next send time, a new frame is started when the last one has been handed over
+void JetiExProtocol::BuildNext()
+{
+  if( m_buildState == BUILD_IDLE )
+  {
+    uint8_t dev = NextDevice();
+    if( dev < m_nDevices )
+      BuildBegin( dev, m_devices[ dev ].frameCnt++ );
+  }
+  else
+    BuildStep();
+}
+
+// frame pipeline: the frame which is due, the remaining steps are done now
+uint8_t JetiExProtocol::FinishFrame()
+{
+  if( m_buildState == BUILD_IDLE )
+    BuildNext();
+  if( m_buildState == BUILD_IDLE )
+    return 0xFF;
+  while( !BuildStep() )
+    ;
+  return m_buildDev;
+}
+
+void JetiExProtocol::SwapFrame()
+{
+  uint8_t * pFrame = m_exBuffer;
+  m_exBuffer   = m_pBuild;
+  m_pBuild     = pFrame;
+  m_buildState = BUILD_IDLE;
+}
+
+
+void JetiExProtocol::SendExBuffer( uint8_t dev, uint8_t n )
+{
+  uint8_t i;
 
   // serial transmission
   m_pSerial->Send( 0x7E, false );                                 // send EX frame header tag
   for( i = 1; i <= n; i++ )                                       // followed by EX data frame (start from byte 1, since 0x7e has already been sent)
     m_pSerial->Send( m_exBuffer[i], true );
-}
+  m_nSymbols += n + 1;
 
+  ExFrameSent( dev, n );
+}
 
-// **************************************
-// Helpers
-// **************************************
-// merge name and unit and terminate with '\0'
-void JetiSensor::copyLabel( const uint8_t * name, const uint8_t * unit,  uint8_t * dest, int dest_size, uint8_t * nameLen, uint8_t * unitLen )
+// bookkeeping after the EX frame in m_exBuffer has been sent
+void JetiExProtocol::ExFrameSent( uint8_t dev, uint8_t n )
 {
-  int maxchar = dest_size -1 ;
+  m_devices[ dev ].nBytes += n + 1;                               // link time used by this device
+  m_nValuesSent           += m_valuesInFrame;
+  if( m_exBuffer[2] & 0x40 )
+    m_nValueFrames++;
+  else
+    m_nDictFrames++;
+
+  // dictionary entry has been sent
+  JetiExDevice * pDevice = &m_devices[ dev ];
+  if( m_exBuffer[2] == ( n - 2 ) && m_exBuffer[8] != 0 && pDevice->nDictPending )
+  {
+    uint8_t idx = pDevice->nSensors;
+    if( pDevice->pWireIds )
+    {
+      for( idx = 0; idx < pDevice->nSensors && pDevice->pWireIds[ idx ] != m_exBuffer[8]; idx++ )
+        ;
+    }
+    else if( m_exBuffer[8] < sizeof( pDevice->sensorMapper ) )
+      idx = pDevice->sensorMapper[ m_exBuffer[8] ];
+    if( idx < pDevice->nSensors )
+      SetDictPending( pDevice, idx, false );
+  }
+}
 
-  uint8_t i = 0, j = 0;
-  while( name[i] != '\0' && j < maxchar )
-    dest[ j++ ] = name[ i++ ];
-  *nameLen = i;
 
-  i = 0;
-  while( unit[i] != '\0' && j < maxchar )
-    dest[ j++ ] = unit[ i++ ];
-  *unitLen = i;
 
-  dest[ j ] = '\0';
-}
+// **************************************
+// Helpers
+// **************************************
 
 // encode sensor value to jeti ex format and copy to buffer
 uint8_t JetiSensor::jetiEncodeValue( uint8_t * exbuf, uint8_t n )
@@ -540,15 +1871,13 @@ uint8_t JetiSensor::jetiEncodeValue( uint8_t * exbuf, uint8_t n )
   return 0;
 }
 
-// copy sensor label to ex buffer
+// copy sensor label (description + unit) from PROGMEM to ex buffer
 uint8_t JetiSensor::jetiCopyLabel( uint8_t * exbuf, uint8_t n )
 {
-  uint8_t i = 0;
-
-  while( m_label[i] != '\0' )
-    exbuf[ n++ ] = m_label[ i++ ];
+  memcpy_P( exbuf + n, m_pText, m_textLen );
+  memcpy_P( exbuf + n + m_textLen, m_pUnit, m_unitLen );
 
-  return( i ) ; // number of bytes copied
+  return m_textLen + m_unitLen; // number of bytes copied
 }
 
 
@@ -24,6 +24,26 @@
                      - JETI_DEBUG and BLOCKING_MODE removed (cleanup)
   1.02   03/28/2017  New sensor memory management. Sensor data can be located in PROGMEM
   1.04   07/18/2017  dynamic sensor de-/activation
+  1.06   10/18/2026  host (Linux) build with -DJETIEX_HOST, Start() with user supplied serial port
+                     timer mode: frames are sent from timer interrupt (StartTimer(), JetiExTimer.cpp)
+                     multiple virtual EX devices (AddDevice())
+                     Jetibox text frame on change only (SetJetiboxTextRefresh())
+                     serial Poll() with every DoJetiSend()
+                     prioritized alarm queue with repeat and spacing
+                     alarm and exit frames share the send window with the EX frame
+                     threshold alarm rules (SetAlarmRules())
+                     SetSensorActive() sends changed dictionary entries only
+                     dictionary refresh policy (SetDictionaryRefresh()), value frame ratio
+                     sensor filters: EMA, average, min/max hold, decimation (SetSensorFilters())
+                     JETIEX_STATIC_SERIAL: built-in serial port without virtual calls and heap
+                     packed sensor table with label string pool (JetiSensorPacked, extras/host/jetipack)
+                     EX Bus transport (JetiExBus)
+                     value validity bit array and timeouts (SetSensorTimeout()), -1 is a regular value
+                     library health as EX sensors (AddHealthDevice()) and GetHealth()
+                     full-rate binary value log (SetLog(), JetiExLog)
+                     short wire ids for the fastest sensors (SetIdRemap())
+                     frame pipeline, next EX frame is assembled in steps (SetFramePipeline())
+                     time-sliced sending (SetSendBudget()), DoJetiSend() duration in health
 
   Permission is hereby granted, free of charge, to any person obtaining
   a copy of this software and associated documentation files (the "Software"),
@@ -49,12 +69,34 @@
 
 #if ARDUINO >= 100
  #include <Arduino.h>
+#elif defined( JETIEX_HOST )
+ #include "JetiExHost.h"
 #else
  #include <WProgram.h>
 #endif
 
 #include "JetiExSerial.h"
-#include <new.h>
+#ifdef JETIEX_HOST
+ #include <new>
+#else
+ #include <new.h>
+#endif
+
+// Timer mode (StartTimer()) uses the TIMER0_COMPB interrupt on AVR CPUs, an IntervalTimer on Teensy (JetiExTimer.cpp).
+// It is linked only when your sketch calls StartTimer(). Uncomment to drive timer mode from your own 1 ms timer:
+// StartTimer() starts no timer then, call OnTimerTick() from your timer ISR.
+// #define JETIEX_NO_TIMER
+
+// The serial port is called through the JetiExSerial interface, so it can be selected at runtime.
+// Uncomment to bind the built-in port of the platform (JetiExDefaultSerial) at compile time: 
+// no virtual calls per symbol, no heap allocation, Start() with a port object takes a JetiExDefaultSerial only.
+// #define JETIEX_STATIC_SERIAL
+
+#ifdef JETIEX_STATIC_SERIAL
+  typedef JetiExDefaultSerial JetiExPort;
+#else
+  typedef JetiExSerial        JetiExPort;
+#endif
 
 // Definition of Jeti sensor (aka "Equipment")
 
@@ -71,6 +113,54 @@ typedef struct /*_JetiSensorConst*/
 JetiSensorConst;
 typedef const JetiSensorConst JETISENSOR_CONST; 
 
+// packed sensor table (can be located in PROGMEM), generated from a JetiSensorConst table by extras/host/jetipack:
+// 6 instead of 30 bytes per sensor, description and unit are stored in a shared string pool
+//////////////////////////////////////////////////////
+typedef struct
+{
+  uint8_t  id;
+  uint8_t  dataType;
+  uint8_t  precision;
+  uint8_t  labelLen;    // description length << 3 | unit length (like in the EX dictionary)
+  uint16_t label;       // offset of description, followed by unit, in string pool
+}
+JetiSensorPacked;
+typedef const JetiSensorPacked JETISENSOR_PACKED; 
+
+// threshold alarm rule (can be located in PROGMEM), i.e.
+// JETIALARMRULE_CONST rules[] PROGMEM = { { ID_VOLTAGE, 'U', 350, JETI_NO_LIMIT, 10, 2000, JetiExProtocol::ALARM_CRITICAL, 3, 1000 }, { 0 } };
+//////////////////////////////////////////////////////
+#define JETI_NO_LIMIT 0x7FFFFFFFL
+typedef struct
+{
+  uint8_t  id;          // sensor id, 0: end of array
+  char     alarmChar;   // morse character, upper case: with sound
+  int32_t  low;         // alarm when value < low, JETI_NO_LIMIT: off
+  int32_t  high;        // alarm when value > high, JETI_NO_LIMIT: off
+  int32_t  hysteresis;  // alarm ends when value is back by hysteresis
+  uint16_t debounceMs;  // limit must be exceeded that long
+  uint8_t  priority;    // see SetJetiAlarm()
+  uint8_t  repeat;      // 0 = 1
+  uint16_t spacingMs;
+  uint8_t  dev;         // device number, see AddDevice()
+}
+JetiAlarmRule;
+typedef const JetiAlarmRule JETIALARMRULE_CONST; 
+
+// sensor filter (can be located in PROGMEM), i.e.
+// JETISENSORFILTER_CONST filters[] PROGMEM = { { ID_VOLTAGE, JetiExProtocol::FILTER_AVG }, { ID_CURRENT, JetiExProtocol::FILTER_MAX, 0, 4 }, { 0 } };
+//////////////////////////////////////////////////////
+typedef struct
+{
+  uint8_t id;           // sensor id, 0: end of array
+  uint8_t type;         // JetiExProtocol::FILTER_...
+  uint8_t param;        // FILTER_EMA: weight of new sample is 1/2^param (1..8)
+  uint8_t decimate;     // use every n-th sample only, 0: all
+  uint8_t dev;          // device number, see AddDevice()
+}
+JetiSensorFilter;
+typedef const JetiSensorFilter JETISENSORFILTER_CONST; 
+
 
 // dynamic sensor data
 //////////////////////
@@ -80,16 +170,21 @@ class JetiValue
   friend class JetiExProtocol;
 public:
 
-  JetiValue() : m_value( -1 ) {}
+  JetiValue() : m_value( 0 ), m_tiUpdate( 0 ), m_timeout( 0 ) {}
 
 protected:
   // value
   int32_t m_value;
+
+  // freshness, see SetSensorTimeout()
+  uint16_t m_tiUpdate;                     // last SetSensorValue() (ms, lower 16 bit)
+  uint16_t m_timeout;                      // ms, 0: value doesn't expire
 };
 
 // complete data for a sensor to fill ex frame buffer
 /////////////////////////////////////////////////////
 class JetiExProtocol;
+class JetiExLog;
 class JetiSensor
 {
 public:
@@ -105,7 +200,9 @@ public:
   }
   EN_DATA_TYPE;
 
-  JetiSensor( int arrIdx, JetiExProtocol * pProtocol );
+  enum { MAX_LABEL = 19 }; // description + unit
+
+  JetiSensor( int arrIdx, JetiExProtocol * pProtocol, uint8_t dev = 0, bool bLabel = false ); // bLabel: for dictionary
 
   // sensor id
   uint8_t m_id;
@@ -116,8 +213,9 @@ public:
   // value
   uint8_t m_bActive;
 
-  // label/description of value
-  uint8_t m_label[ 20 ];
+  // label/description of value (PROGMEM), with bLabel only
+  const uint8_t * m_pText;
+  const uint8_t * m_pUnit;
   uint8_t m_textLen;
   uint8_t m_unitLen;
 
@@ -127,7 +225,6 @@ public:
   uint8_t  m_bufLen;
 
   // helpers
-  void    copyLabel( const uint8_t * text, const uint8_t * unit,  uint8_t * label, int label_size, uint8_t * textLen, uint8_t * unitLen );
   uint8_t jetiCopyLabel( uint8_t * exbuf, uint8_t n );
   uint8_t jetiEncodeValue( uint8_t * exbuf, uint8_t n );
 };
@@ -163,63 +260,366 @@ public:
   JetiExProtocol();
 
   void    Start( const char * name,  JETISENSOR_CONST * pSensorArray, enComPort comPort = DEFAULTPORT );   // call once in setup(), comPort: 0=Default, Teensy: 1..3
+  void    Start( const char * name,  JETISENSOR_CONST * pSensorArray, JetiExPort * pSerial );              // same as above, with your own serial port object (i.e. host capture/replay)
+  void    Start( const char * name,  JETISENSOR_PACKED * pSensors, const char * pPool, enComPort comPort = DEFAULTPORT ); // packed sensor table, see jetipack
+  void    Start( const char * name,  JETISENSOR_PACKED * pSensors, const char * pPool, JetiExPort * pSerial );
   uint8_t DoJetiSend();                                                 // call periodically in loop()
 
-  void SetDeviceId( uint8_t idLo, uint8_t idHi ) { m_devIdLow = idLo; m_devIdHi = idHi; } // adapt it, when you have multiple sensor devices connected to your REX
-  void SetSensorValue( uint8_t id, int32_t value );
-  void SetSensorValueGPS( uint8_t id, bool bLongitude, float value );
-  void SetSensorValueDate( uint8_t id, uint8_t day, uint8_t month, uint16_t year );
-  void SetSensorValueTime( uint8_t id, uint8_t hour, uint8_t minute, uint8_t second );
-  void SetSensorActive( uint8_t id, bool bEnable, JETISENSOR_CONST * pSensorArray );
+  // Timer mode: frames are assembled and sent from a 1 ms timer interrupt (AVR: Timer0 compare B, Teensy: IntervalTimer),
+  // independent of loop() timing. Call StartTimer() after Start(), DoJetiSend() does nothing in timer mode.
+  // ISR policy: while the timer is running, loop() may call SetSensorValue...(), SetJetiboxText(), SetJetiAlarm(), 
+  // SetJetiboxExit(), SetSensorActive() and GetJetiboxKey() only. These are interrupt safe, the ISR reads the 
+  // values as they are at the time of frame assembly. Don't call Start() or SetDeviceId() while the timer is running.
+  // Host build and JETIEX_NO_TIMER: StartTimer() starts no timer, call OnTimerTick() every ms yourself.
+  bool    StartTimer();                                                 // false: before Start(), other instance in timer mode or timer not available (Teensy: all PIT channels in use)
+  void    StopTimer();
+  void    OnTimerTick();                                                // timer ISR entry, call it from your own 1 ms timer ISR alternatively
+
+  // Virtual EX devices: more than 31 sensors from one board. Each device has its own id, name and sensor array,
+  // link time is shared fairly between the devices. Call AddDevice() before Start(), device 0 is the one from Start().
+  // Use the returned device number as last parameter of SetSensorValue...() and SetSensorActive().
+  int  AddDevice( const char * name, JETISENSOR_CONST * pSensorArray, uint8_t idLo, uint8_t idHi ); // returns device number 1.., -1: increase MAX_DEVICES
+  int  AddDevice( const char * name, JETISENSOR_PACKED * pSensors, const char * pPool, uint8_t idLo, uint8_t idHi );
+
+  void SetDeviceId( uint8_t idLo, uint8_t idHi ) { m_devices[ 0 ].devIdLow = idLo; m_devices[ 0 ].devIdHi = idHi; } // adapt it, when you have multiple sensor devices connected to your REX
+  void SetSensorValue( uint8_t id, int32_t value, uint8_t dev = 0 );
+  void SetSensorValueGPS( uint8_t id, bool bLongitude, float value, uint8_t dev = 0 );
+  void SetSensorValueDate( uint8_t id, uint8_t day, uint8_t month, uint16_t year, uint8_t dev = 0 );
+  void SetSensorValueTime( uint8_t id, uint8_t hour, uint8_t minute, uint8_t second, uint8_t dev = 0 );
+  void SetSensorActive( uint8_t id, bool bEnable, JETISENSOR_CONST * pSensorArray, uint8_t dev = 0 );
+
+  // value validity: a sensor is sent after its first SetSensorValue...(), all values incl. -1 are valid
+  // with a timeout a value which has not been set for timeoutMs is no longer sent, the next SetSensorValue...()
+  // brings it back, call after Start(), id 0: all sensors of the device, timeoutMs 0: no timeout (default)
+  // the time stamp has 16 bit: DoJetiSend() checks one value per call, keep timeoutMs below 60000
+  void SetSensorTimeout( uint8_t id, uint16_t timeoutMs, uint8_t dev = 0 );
+  void SetSensorValueInvalid( uint8_t id, uint8_t dev = 0 );  // stop sending until next SetSensorValue...()
+  bool IsSensorValueValid( uint8_t id, uint8_t dev = 0 );     // set and not expired
   void SetJetiboxText( enLineNo lineNo, const char* text );
+  void SetJetiboxTextRefresh( uint16_t keepAliveMs ) { m_textKeepAlive = keepAliveMs; } // 0: text frame after every frame (default), 
+                                                                                       // else only on change, after a key and every keepAliveMs, more EX frames in the time saved
   void SetJetiboxExit() { m_bExitNav = true; };
-  void SetJetiAlarm( char alarmChar ) { m_alarmChar = alarmChar; }
+
+  // alarms are queued (MAX_ALARMS), the highest priority alarm which is due goes out with the next frame
+  // identical pending alarms are merged, a full queue drops the lowest priority alarm
+  enum enAlarmPriority
+  {
+    ALARM_NORMAL   = 0,
+    ALARM_HIGH     = 1,
+    ALARM_CRITICAL = 2,  // i.e. low voltage
+  };
+  bool SetJetiAlarm( char alarmChar, uint8_t priority = ALARM_NORMAL, uint8_t repeat = 1, uint16_t spacingMs = 0 ); // upper case: with sound; false: queue full
+
+  // threshold alarms: rules are evaluated when SetSensorValue...() changes a value (filtered sensors: on every filter result),
+  // debounce time is checked in DoJetiSend()
+  void SetAlarmRules( JETIALARMRULE_CONST * pRules );   // max. MAX_ALARM_RULES
 
   uint8_t GetJetiboxKey();
 
+  uint32_t GetExFramesSkipped() { return m_nExSkipped; } // EX frames replaced by alarm or exit frames (transmit buffer too small for both)
+
+  // dictionary refresh after the startup phase
+  enum enDictRefresh
+  {
+    DICT_REFRESH_WRAP    = 0,  // full dictionary every 256 frames (default)
+    DICT_REFRESH_TRICKLE = 1,  // one dictionary entry every trickleFrames value frames
+    DICT_REFRESH_ONCE    = 2,  // at startup and after RequestDictionary() only
+  };
+  void    SetDictionaryRefresh( enDictRefresh policy, uint8_t trickleFrames = 16 ) { m_dictRefresh = policy; m_dictTrickle = trickleFrames; }
+  void    RequestDictionary( uint8_t dev = 0 );  // send full dictionary again
+  uint8_t GetValueFrameRatio();                  // EX frames with values since Start() in percent
+
+  // wire ids: a value with id 1..15 takes one byte less in the EX frame than one with id 16..31.
+  // With remapping the sensors of device dev are numbered 1..n on the wire: first the ids in pFastIds
+  // (0 terminated, highest rate first), then the active and at last the inactive sensors in table order.
+  // The application keeps the ids of the sensor table, the dictionary is sent with the wire ids,
+  // so the transmitter sees the wire ids. Call before Start(), pFastIds must be valid until Start().
+  bool    SetIdRemap( bool bEnable, const uint8_t * pFastIds = 0, uint8_t dev = 0 );
+
+  // frame pipeline: the next EX frame is assembled in a second buffer during the last leadMs before it is due,
+  // one step (dictionary entry or value) per DoJetiSend() call, at the send time the buffers are swapped.
+  // Values are taken when they are added to the frame, up to leadMs before the frame is sent.
+  // EX Bus: the next frame is assembled after each answer. Call before Start(), false: no memory
+  bool    SetFramePipeline( bool bEnable, uint8_t leadMs = 20 );
+
+  // time-sliced sending: a DoJetiSend() call does at most maxUnits units of work (a symbol sent or a step of the
+  // next frame) and stops after maxUs (checked after each unit), the rest of the window follows with the next calls.
+  // Enables the frame pipeline. EX Bus answers with one write, the pipeline alone gives one frame step per call there.
+  // 0, 0: off (default). Call before Start(), false: no memory
+  bool    SetSendBudget( uint16_t maxUs, uint8_t maxUnits = 0 );
+
+  // sensor filters: samples from SetSensorValue() are filtered in fixed point, the filter result is transmitted
+  // FILTER_AVG/MIN/MAX start again when the result is put into an EX frame (again with the samples of the result,
+  // if the frame is not sent), so no peak is lost between two EX frames
+  // call after Start(), max. MAX_FILTERS, false: not started or no memory. Entries with an id which is not in the
+  // sensor table of their device, a second filter for a sensor, an unknown type or a FILTER_EMA param outside 1..8 are skipped
+  enum enFilterType
+  {
+    FILTER_EMA = 1,  // exponential moving average, value << param must fit into 32 bit (param 8: 22 bit values)
+    FILTER_AVG = 2,  // average since last transmission, sum must fit into 32 bit
+    FILTER_MIN = 3,  // minimum since last transmission
+    FILTER_MAX = 4,  // maximum since last transmission
+  };
+  bool SetSensorFilters( JETISENSORFILTER_CONST * pFilters );
+
+  // library health, measured between two health frames (or GetHealth() calls without health device)
+  typedef struct
+  {
+    uint8_t  linkLoad;        // % of link time used by this sensor
+    uint16_t refreshMs;       // average time between two transmissions of a value
+    uint16_t txHighWater;     // max. symbols in transmit buffer since Start()
+    uint16_t txOverflows;     // symbols lost since Start(), transmit buffer full
+    uint16_t loopJitterUs;    // longest minus shortest time between two DoJetiSend() calls
+    uint16_t loopMaxUs;       // longest time between two DoJetiSend() calls
+    uint16_t sendMaxUs;       // longest DoJetiSend() call
+    uint16_t sendMeanUs;      // average DoJetiSend() call
+  }
+  Health;
+  void GetHealth( Health & health );
+
+  // health as EX sensors of an own virtual device (see AddDevice(), needs a free device), ids 1..7 are reserved:
+  // one frame every intervalMs (dictionary entries first, then values), outside of the fair share of the other devices.
+  // DICT_REFRESH_WRAP: the dictionary of the health device is refreshed by trickling. Call before Start().
+  enum enHealthId
+  {
+    HEALTH_LINK     = 1,    // %
+    HEALTH_REFRESH  = 2,    // ms
+    HEALTH_TXHIGH   = 3,    // symbols
+    HEALTH_OVERFLOW = 4,
+    HEALTH_JITTER   = 5,    // ms, 1 decimal
+    HEALTH_LOOPMAX  = 6,    // ms, 1 decimal
+    HEALTH_SENDMAX  = 7,    // us
+  };
+  int  AddHealthDevice( const char * name, uint8_t idLo, uint8_t idHi, uint16_t intervalMs = 2000 ); // returns device number, -1: no free device
+
+  // log every SetSensorValue() call (see JetiExLog.h), after Start(): writes the sensor table header. 0: no log
+  bool SetLog( JetiExLog * pLog );
+
 protected:
   enum
   {
     MAX_SENSORS   = 32, // increase up to 255 if necessary, 31 is max for DC16/DS/16
+    MAX_DEVICES   = 2,  // virtual EX devices, increase if you need more than 2 x 31 sensors
+    MAX_ALARMS    = 4,  // pending alarms
+    MAX_ALARM_RULES = 8, // threshold alarm rules
+    MAX_FILTERS   = 8,  // sensor filters
+
+    SEND_INTERVAL        = 150, // ms, EX or alarm frame followed by text frame
+    SEND_INTERVAL_NOTEXT = 70,  // ms, without text frame (same share of link time per symbol)
 
    MAX_SENSORBYTES = (MAX_SENSORS / 8) + ( MAX_SENSORS % 8 ? 1:0)
   };
 
-  void SendExFrame( uint8_t frameCnt );
+  // virtual EX device
+  typedef struct
+  {
+    // sensor name
+    char               name[ 20 ];
+    uint8_t            nameLen;
+
+    // device id
+    uint8_t            devIdLow;
+    uint8_t            devIdHi;
+
+    // EX frame control
+    uint8_t            frameCnt;
+    uint16_t           nBytes;                      // bytes sent, for fair share of link time
+
+    // sensor array
+    JETISENSOR_CONST * pSensorsConst;               // array to constant sensor definitions
+    JETISENSOR_PACKED * pSensorsPacked;             // or packed sensor definitions
+    const char       * pPool;                       // and their string pool
+    JetiValue        * pValues;                     // sensor value array, same order as constant data array
+    int                nSensors;                    // number of sensors
+    uint8_t            sensorIdx;                   // current index to sensor array to send value
+    uint8_t            dictIdx;                     // current index to sensor array to send sensor dictionary
+    uint8_t            sensorMapper[ MAX_SENSORS ]; // id to idx lookup table to accelerate SetSensorValue()
+    const uint8_t    * pFastIds;                    // SetIdRemap() until Start()
+    uint8_t          * pWireIds;                    // idx to wire id, 0: ids of the sensor table
+    uint8_t            activeSensors[ MAX_SENSORBYTES ]; // bit array for active sensor bit field
+    uint8_t            dictPending[ MAX_SENSORBYTES ];   // bit array for dictionary entries to be sent
+    uint8_t            filter[ MAX_SENSORS ];       // idx to filter index + 1, 0: no filter
+    uint8_t            valid[ MAX_SENSORBYTES ];         // bit array for sensors with valid value
+    uint8_t            nDictPending;
+    uint8_t            dictState;                   // DICT_DONE, DICT_NAME
+    uint8_t            trickleCnt;                  // value frames since last dictionary entry
+  }
+  JetiExDevice;
+
+  uint8_t DoSend();
+  void    SendExFrame( uint8_t dev, uint8_t frameCnt );
+  uint8_t BuildExFrame( uint8_t dev, uint8_t frameCnt );
+  void    SendExBuffer( uint8_t dev, uint8_t n );
+  void    BuildBegin( uint8_t dev, uint8_t frameCnt );
+  bool    BuildStep();                     // true: frame is complete
+  void    BuildEnd();
+  void    BuildNext();                     // pipeline: one step of the next frame
+  uint8_t FinishFrame();                   // pipeline: complete the next frame, returns device, 0xFF: none
+  void    SwapFrame();                     // assembled frame becomes m_exBuffer
+  void    RestoreFilters();
+  bool    EnterTimerMode( bool ( * pStartIsr )( JetiExProtocol * ) );
+  void    LeaveTimerMode( void ( * pStopIsr )() );
   void SendJetiboxTextFrame();
+  bool IsTextFrameDue();
   void SendJetiboxExit();
   void SendJetiAlarm( char code );
-
-  void InitSensorMapper( JETISENSOR_CONST * pSensorArray );
+  void SendCtrl( const uint8_t * pFrame, uint8_t n );
+  static uint8_t BuildExit( uint8_t * pFrame );
+  static uint8_t BuildAlarm( uint8_t * pFrame, char code );
+  uint8_t NextWindow( uint8_t & dev, char & alarm, bool & bExit, bool & bText );
+  bool    SliceStep();
+  char NextAlarm();
+  void CheckAlarmRules( uint8_t dev, uint8_t id, int32_t value );
+  void CheckPendingRules();
+  void FilterSample( uint8_t i, int32_t value );
+  void FilterOutput( uint8_t i );
+  void FilterReset( uint8_t i );
+  bool CheckValid( JetiExDevice * pDevice, uint8_t idx );
+  void CheckNextTimeout();
+  void Wait( uint16_t ms );
+
+  int8_t  InitStart( const char * name, JETISENSOR_CONST * pSensorArray ); // returns number of devices with sensors, -1: started before
+  void    ExFrameSent( uint8_t dev, uint8_t n );
+  void    InitDevice( uint8_t dev, const char * name, uint8_t idLo, uint8_t idHi );
+  void    InitSensorMapper( uint8_t dev, JETISENSOR_CONST * pSensorArray, JETISENSOR_PACKED * pPacked = 0, const char * pPool = 0 );
+  void    InitWireIds( uint8_t dev );
+  static uint8_t SensorId( const JetiExDevice * pDevice, uint8_t idx );  // id in sensor table
+  static bool HasSensors( const JetiExDevice * pDevice ) { return pDevice->pSensorsConst || pDevice->pSensorsPacked; }
+  void    SetDictPending( JetiExDevice * pDevice, uint8_t idx, bool bPending );
+  uint8_t NextDevice();
+  void    HealthLoop();
+  void    HealthLoopEnd();
+  bool    IsHealthDevice( uint8_t dev ) { return m_healthDev != 0 && dev == m_healthDev; }
+  void    UpdateHealth();
+  void    NextHealthWindow();
 
   // EX frame control
   unsigned long      m_tiLastSend;         // last send time
-  uint8_t            m_frameCnt;          
-
-  // sensor name
-  char               m_name[ 20 ];
-  uint8_t            m_nameLen;
+  uint8_t            m_sendInterval;       // ms until next send
+  volatile bool      m_bTimerMode;         // frames are sent from timer ISR
 
-  // sensor array
-  JETISENSOR_CONST * m_pSensorsConst;               // array to constant sensor definitions
-  JetiValue        * m_pValues;                     // sensor value array, same order as constant data array
-  int                m_nSensors;                    // number of sensors
-  uint8_t            m_sensorIdx;                   // current index to sensor array to send value
-  uint8_t            m_dictIdx;                     // current index to sensor array to send sensor dictionary
-  uint8_t            m_sensorMapper[ MAX_SENSORS ]; // id to idx lookup table to accelerate SetSensorValue()
-  uint8_t            m_activeSensors[ MAX_SENSORBYTES ]; // bit array for active sensor bit field
+  // virtual devices
+  JetiExDevice       m_devices[ MAX_DEVICES ];
+  uint8_t            m_nDevices;
 
   // serial interface
-  JetiExSerial     * m_pSerial;
+  JetiExPort       * m_pSerial;
+#ifdef JETIEX_STATIC_SERIAL
+  JetiExDefaultSerial m_serial;            // built-in port, no heap
+#endif
 
-  // EX frame buffer
-  uint8_t m_exBuffer[32]; 
+  // EX frame buffer, frame pipeline: m_pBuild is assembled in a second buffer
+  uint8_t   m_exFrame[32];
+  uint8_t * m_exBuffer;                    // frame to send
+  uint8_t * m_pBuild;                      // frame in assembly
+  uint8_t * m_pPipeBuffer;                 // second buffer, 0: no pipeline
+  uint8_t   m_pipeLead;                    // ms before the send time
+  uint8_t   m_buildState;                  // BUILD_IDLE, BUILD_VALUES, BUILD_DONE
+  uint8_t   m_buildDev;
+  uint8_t   m_buildN;                      // bytes in m_pBuild, position of crc when done
+  uint8_t   m_buildVal;                    // sensors visited in value frame
+  enum enBuildState
+  {
+    BUILD_IDLE   = 0,
+    BUILD_VALUES = 1,
+    BUILD_DONE   = 2,
+  };
+
+  // time-sliced sending (SetSendBudget()): window in progress
+  uint16_t  m_budgetUs;
+  uint8_t   m_budgetUnits;
+  uint8_t   m_outState;                    // OUT_IDLE, OUT_EX, OUT_CTRL, OUT_TEXT
+  uint8_t   m_outPos;                      // next symbol of the current part
+  uint8_t   m_outN;                        // symbols of the EX frame in m_exBuffer
+  uint8_t   m_outCtrl[ 4 ];                // alarm or exit frame
+  uint8_t   m_nOutCtrl;
+  bool      m_bOutText;
+  char      m_outText[ 32 ];               // text frame, copied at the start of the window
+  enum enOutState
+  {
+    OUT_IDLE = 0,
+    OUT_EX   = 1,
+    OUT_CTRL = 2,
+    OUT_TEXT = 3,
+  };
 
   // Jetibox text buffer
   char m_textBuffer[32]; 
+  volatile bool      m_bTextChanged;       // text changed or key pressed since last text frame
+  uint16_t           m_textKeepAlive;      // ms, 0: send text with every frame
+  unsigned long      m_tiLastText;         // last text frame
 
-  // alarm request
-  char m_alarmChar;
+  // alarm queue, in order of arrival
+  typedef struct
+  {
+    char          code;
+    uint8_t       priority;
+    uint8_t       repeat;                  // remaining transmissions
+    uint16_t      spacing;                 // ms between repetitions
+    unsigned long tiNext;                  // earliest time for next transmission
+  }
+  JetiExAlarm;
+  JetiExAlarm     m_alarms[ MAX_ALARMS ];
+  uint8_t         m_nAlarms;
+  uint32_t        m_nExSkipped;            // EX frames replaced by alarm/exit
+
+  // threshold alarm rules
+  enum { RULE_IDLE, RULE_PENDING, RULE_ACTIVE };
+  JETIALARMRULE_CONST * m_pRules;
+  uint8_t         m_nRules;
+  uint8_t         m_ruleState[ MAX_ALARM_RULES ];
+  uint16_t        m_tiRule[ MAX_ALARM_RULES ];  // start of debounce time (ms, lower 16 bit)
+  volatile uint8_t m_rulesPending;         // bit array of rules in debounce time
+
+  // value timeouts: next value checked by DoJetiSend()
+  uint8_t         m_timeoutDev;
+  uint8_t         m_timeoutIdx;
+
+  // dictionary refresh
+  enum { DICT_DONE = 0x01, DICT_NAME = 0x02 };  // dictState: startup phase done, name is next in trickle mode
+  uint8_t         m_dictRefresh;
+  uint8_t         m_dictTrickle;
+  uint32_t        m_nValueFrames;
+  uint32_t        m_nDictFrames;
+
+  // sensor filters
+  typedef struct
+  {
+    uint8_t  dev;
+    uint8_t  idx;                          // index to sensor array
+    uint8_t  type;
+    uint8_t  param;
+    uint8_t  decimate;
+    uint8_t  decimCnt;
+    uint16_t count;                        // samples since start
+    int32_t  acc;                          // EMA: value << param, AVG: sum, MIN/MAX: min/max
+    uint16_t outCount;                     // AVG/MIN/MAX: count and acc of the result in the current frame
+    int32_t  outAcc;
+  }
+  JetiExFilter;
+  JetiExFilter *  m_pFilters;
+  uint8_t         m_nFilters;
+  uint8_t         m_filtersInFrame;        // bit array of filters with result in the EX frame being built
+
+  // health
+  uint8_t         m_healthDev;             // device number, 0: none
+  uint16_t        m_healthInterval;        // ms between health frames
+  uint16_t        m_symbolUs;              // link time per symbol/byte
+  unsigned long   m_tiHealth;              // start of measurement (ms)
+  uint32_t        m_nSymbols;              // symbols sent since m_tiHealth
+  uint32_t        m_nValuesSent;           // values sent since m_tiHealth
+  uint8_t         m_valuesInFrame;         // values in m_pBuild
+  unsigned long   m_tiLoop;                // last DoJetiSend() (us)
+  unsigned long   m_loopMin;
+  unsigned long   m_loopMax;
+  unsigned long   m_sendMax;               // longest DoJetiSend() call (us)
+  uint32_t        m_sendSum;
+  uint32_t        m_nSendCalls;
+  Health          m_health;
+
+  // value log
+  JetiExLog *     m_pLog;
+  uint16_t        LogSlot( uint8_t dev, uint8_t idx );
 
   // request exit sequence for jetibox navigation
   bool m_bExitNav;
@@ -234,10 +634,19 @@ protected:
     DEVICE_ID_HI        = 0x32,
     POLY                = 0x07, // constant for for "crypt"
   };
-  uint8_t m_devIdLow;
-  uint8_t m_devIdHi;
   uint8_t update_crc (uint8_t crc, uint8_t crc_seed);
   uint8_t jeti_crc8 (uint8_t *exbuf, unsigned char framelen);
 };
 
+// Timer mode: inline, so the built-in timer (JetiExTimer.cpp) and its interrupt vector are referenced by sketches using it only
+#if defined( JETIEX_HOST ) || defined( JETIEX_NO_TIMER )
+  inline bool JetiExProtocol::StartTimer() { return EnterTimerMode( 0 ); }
+  inline void JetiExProtocol::StopTimer()  { LeaveTimerMode( 0 ); }
+#else
+  bool JetiExTimerStart( JetiExProtocol * pInstance );   // false: timer not available
+  void JetiExTimerStop();
+  inline bool JetiExProtocol::StartTimer() { return EnterTimerMode( JetiExTimerStart ); }
+  inline void JetiExProtocol::StopTimer()  { LeaveTimerMode( JetiExTimerStop ); }
+#endif
+
 #endif // JETIEXPROTOCOL_H
@@ -21,6 +21,12 @@
                      GetKey routine optimized 
   1.0.3  07/14/2017  Allow all jetibox key combinations (thanks to ThomasL)
                      Disable RX at startup to prevent reception of receiver identification
+  1.06   10/18/2026  host (Linux) build with -DJETIEX_HOST
+                     Send()/Getchar() restore interrupt state, can be called from timer ISR
+                     Teensy: own TX ring buffer, non-blocking Send(), Poll()
+                     Send() moved to JetiExSerial.h (inline)
+                     USART_RX_vect passes bytes to JetiExRxHandler (EX Bus)
+                     transmit buffer high water mark and overflow counter
 
   Permission is hereby granted, free of charge, to any person obtaining
   a copy of this software and associated documentation files (the "Software"),
@@ -53,7 +59,13 @@
     return new JetiExTeensySerial( comPort );
   } 
 
-  JetiExTeensySerial::JetiExTeensySerial( int comPort ) : m_bNextIsKey( false )
+  JetiExTeensySerial::JetiExTeensySerial( int comPort ) : m_bNextIsKey( false ), m_txHead( 0 ), m_txTail( 0 ), m_txNumChar( 0 ),
+                                                         m_txHighWater( 0 ), m_txOverflows( 0 )
+  {
+    SetComPort( comPort );
+  }
+
+  void JetiExTeensySerial::SetComPort( int comPort )
   {
     switch( comPort )
     {
@@ -68,10 +80,15 @@
   {
      m_pSerial->begin( 9600, SERIAL_9O1 );
   }
-  void JetiExTeensySerial::Send( uint8_t data, boolean bit8 )
+  void JetiExTeensySerial::Poll()
   {
-    uint32_t w = data | ( bit8 ? 0x100 : 0x000 );
-    m_pSerial->write9bit(w);
+    // feed core UART buffer without waiting
+    while( m_txNumChar && m_pSerial->availableForWrite() > 0 )
+    {
+      m_pSerial->write9bit( m_txBuf[ m_txTail ] );
+      m_txTail = ( m_txTail + 1 ) % TX_RINGBUF_SIZE;
+      m_txNumChar--;
+    }
   }
   uint8_t JetiExTeensySerial::Getchar(void) // you must modify \Arduino\hardware\teensy\avr\cores\teensy3\serial2.c in order to receive jeti keys 
   {                                         // refer to TeensyReadme.txt
@@ -86,6 +103,15 @@
     return 0;
   }
 
+// Host (Linux)
+///////////////
+#elif defined( JETIEX_HOST )
+
+  JetiExSerial * JetiExSerial::CreatePort( int comPort )
+  {
+    return new JetiExHostSerial();
+  }
+
 #else
 
 // ATMega
@@ -101,7 +127,7 @@ void JetiExAtMegaSerial::Init() // pins are unsued for hardware version
   // init UART-registers
   UCSRA = 0x00;
   UCSRB = _BV(UCSZ2) /* | _BV(RXEN) */  | _BV(TXEN);        // 0x1C: 9 Bit, RX disable, Tx enable
-  UCSRC = _BV(UCSZ0) | _BV(UCSZ1) | _BV(UPM0) | _BV(UPM1) ; // 0x36: 9-bit data, 2 stop bits, odd parity
+  UCSRC = _BV(UCSZ0) | _BV(UCSZ1) | _BV(UPM0) | _BV(UPM1) ; // 0x36: 9-bit data, 1 stop bit, odd parity
 
   // wormfood.net/avrbaudcalc.php 
 #if F_CPU == 16000000L  // for the 16 MHz clock on most Arduino boards
@@ -127,6 +153,7 @@ void JetiExAtMegaSerial::Init() // pins are unsued for hardware version
 // Interrupt driven transmission
 ////////////////////////////////
 JetiExHardwareSerialInt * _pInstance = 0;   // instance pointer to find the serial object from ISR
+JetiExRxHandler * volatile _pRxHandler = 0; // EX Bus
 
 // static function for port object creation
 JetiExSerial * JetiExSerial::CreatePort( int comPort )
@@ -143,6 +170,8 @@ void JetiExHardwareSerialInt::Init()
   m_txHeadPtr = m_txBuf;
   m_txTailPtr = m_txBuf;
   m_txNumChar = 0;
+  m_txHighWater = 0;
+  m_txOverflows = 0;
 
   // init rx ring buffer 
   memset( (void*)m_rxBuf, 0, sizeof( m_rxBuf ) );
@@ -161,55 +190,15 @@ uint8_t JetiExHardwareSerialInt::Getchar(void)
 
   if( m_rxNumChar ) // atomic operation
   {
-    cli();
+    JETIEX_LOCK();
     c = *(_pInstance->m_rxTailPtr);
     m_rxNumChar--; 
     m_rxTailPtr = IncBufPtr8( m_rxTailPtr, m_rxBuf, RX_RINGBUF_SIZE );
-    sei();
+    JETIEX_UNLOCK();
   }
   return c;
 }
 
-// Send one byte  
-void JetiExHardwareSerialInt::Send( uint8_t data, boolean bit8 )
-{
-  cli();
-  if( m_txNumChar < TX_RINGBUF_SIZE )
-  {
-     *m_txHeadPtr = data | (bit8 ? 0x0100 : 0x0000);                       // write data to buffer
-      m_txNumChar++;                                                       // increase number of characters in buffer
-      m_txHeadPtr = IncBufPtr( m_txHeadPtr, m_txBuf, TX_RINGBUF_SIZE );    // increase ringbuf pointer
-  }
-  else
-  {
-    // todo handle buffer overflow
-    // digitalWrite( 13, HIGH ); 
-  }
-
-  // enable transmitter
-  if( !m_bSending )
-  {
-    m_bSending    = true;
-    uint8_t ucsrb = UCSRB;
-    ucsrb        &= ~( (1<<RXEN) | (1<<RXCIE) ); // disable receiver and receiver interrupt
-    ucsrb        |=    (1<<TXEN) | (1<<UDRIE);   // enable transmitter and tx register empty interrupt 
-    UCSRB         = ucsrb;
-
-    // digitalWrite( 13, HIGH ); // show transmission
-  }
-  sei();
-}
-
-// increment buffer pointer (todo: use templates for 8 and 16 bit versions of pointers)
-volatile uint16_t * JetiExHardwareSerialInt::IncBufPtr( volatile uint16_t * ptr, volatile uint16_t * pRingBuf, size_t bufSize )
-{
-  ptr++;
-  if( ptr >= ( pRingBuf + bufSize ) )
-    return pRingBuf; // wrap around
-  else
-    return ptr;
-}
-
 volatile uint8_t * JetiExHardwareSerialInt::IncBufPtr8( volatile uint8_t * ptr, volatile uint8_t * pRingBuf, size_t bufSize )
 {
   ptr++;
@@ -272,6 +261,11 @@ ISR( USART_RX_vect )
   // uint8_t status = UCSR0A;
   // uint8_t bit8 = UCSR0B; // unused
   uint8_t c = UDR;
+  if( _pRxHandler )
+  {
+    _pRxHandler->OnReceive( c );
+    return;
+  }
   // if( c == 0x70 || c == 0xb0 || c == 0xd0 || c == 0xe0 ) // Left = 0x70, down = 0xb0, up= 0xd0, right = 0xe0
   if( c != 0xf0 && (c & 0x0f) == 0 )   // check upper nibble
   {
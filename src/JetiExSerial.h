@@ -17,6 +17,15 @@
                      - Changed bitrates for serial communication for AVR CPUs (9600-->9800 bps)
                      - JETI_DEBUG and BLOCKING_MODE removed (cleanup)
   1.0.1  02/15/2017  Support for ATMega32u4 CPU in Leonardo/Pro Micro
+  1.06   10/18/2026  host (Linux) build with -DJETIEX_HOST
+                     interrupt safe critical sections (JETIEX_LOCK/JETIEX_UNLOCK)
+                     Teensy: own TX ring buffer, non-blocking Send(), Poll()
+                     TxFree(), TX ring buffer 64-->70 words (alarm frame in same window as EX and text frame)
+                     built-in ports are final, Send() inline, JetiExDefaultSerial (JETIEX_STATIC_SERIAL)
+                     SYMBOL_US: duration of one EX symbol
+                     UART status bit names for polled EX Bus port
+                     JetiExRxHandler: receiver ISR hook for EX Bus (AVR)
+                     TxHighWater(), TxOverflows()
 
   Permission is hereby granted, free of charge, to any person obtaining
   a copy of this software and associated documentation files (the "Software"),
@@ -43,13 +52,41 @@
 
 #if ARDUINO >= 100
  #include <Arduino.h>
+#elif defined( JETIEX_HOST )
+ #include "JetiExHost.h"
 #else
  #include <WProgram.h>
 #endif
 
+// critical section, restores previous interrupt state (can be used in ISRs and nested)
+#if defined( JETIEX_HOST )
+  #define JETIEX_LOCK()
+  #define JETIEX_UNLOCK()
+#elif defined( CORE_TEENSY )
+  #define JETIEX_LOCK()   uint32_t _primask; __asm__ volatile( "mrs %0, primask\n" : "=r" (_primask) :: ); __disable_irq();
+  #define JETIEX_UNLOCK() if( !_primask ) __enable_irq();
+#else
+  #include <avr/io.h>
+  #include <avr/interrupt.h>
+  #define JETIEX_LOCK()   uint8_t _sreg = SREG; cli();
+  #define JETIEX_UNLOCK() SREG = _sreg;
+#endif
+
+// receiver interrupt hook, i.e. EX Bus parser (AVR: called from USART_RX_vect instead of Jetibox key handling)
+class JetiExRxHandler
+{
+public:
+  virtual void OnReceive( uint8_t c ) = 0;
+};
+
 class JetiExSerial
 {
 public:
+  enum
+  {
+    SYMBOL_US = 1225, // EX link: 9O1 = 12 bits (start, 9 data, parity, stop) at 9800 bps, Teensy 9600 bps: 1250
+  };
+
   static JetiExSerial * CreatePort( int comPort ); // comPort: 0=default, Teensy: 1..3
 
   virtual void    Init() = 0;
@@ -58,26 +95,84 @@ public:
 
   virtual void TxOn() = 0;
   virtual void TxOff() = 0;
+
+  virtual void     Poll() {}                       // called with every DoJetiSend(), for ports which feed the UART from loop()
+  virtual uint16_t TxFree() { return 0xFFFF; }     // free space in transmit buffer (symbols)
+  virtual uint16_t TxHighWater() { return 0; }     // max. symbols in transmit buffer, 0: unknown
+  virtual uint16_t TxOverflows() { return 0; }     // symbols lost, transmit buffer full
 };
 
 // Teensy
 /////////
 #ifdef CORE_TEENSY 
 
-  class JetiExTeensySerial : public JetiExSerial
+  // symbols are queued in an own ring buffer and written to the core UART buffer
+  // as space becomes available (Poll()), Send() never waits
+  class JetiExTeensySerial final : public JetiExSerial
   {
   public:
-    JetiExTeensySerial( int comPort );
+    JetiExTeensySerial( int comPort = 2 );
+    void SetComPort( int comPort );
     virtual void Init();
-    virtual void Send( uint8_t data, boolean bit8 );
+    virtual void Send( uint8_t data, boolean bit8 )
+    {
+      if( m_txNumChar < TX_RINGBUF_SIZE )
+      {
+        m_txBuf[ m_txHead ] = data | ( bit8 ? 0x100 : 0x000 );
+        m_txHead = ( m_txHead + 1 ) % TX_RINGBUF_SIZE;
+        if( ++m_txNumChar > m_txHighWater )
+          m_txHighWater = m_txNumChar;
+      }
+      else
+        m_txOverflows++;  // symbol is lost like in JetiExHardwareSerialInt
+
+      Poll();
+    }
     virtual uint8_t Getchar(void);
     virtual void TxOn() {}
     virtual void TxOff() {}
+    virtual void Poll();
+    virtual uint16_t TxFree() { return TX_RINGBUF_SIZE - m_txNumChar + m_pSerial->availableForWrite(); }
+    virtual uint16_t TxHighWater() { return m_txHighWater; }
+    virtual uint16_t TxOverflows() { return m_txOverflows; }
   protected:
+    enum
+    {
+      TX_RINGBUF_SIZE = 70, // 34 bytes text frame plus 32 bytes ex frame buffer plus 4 bytes alarm: a full window fits
+    };
+
     bool m_bNextIsKey;
     HardwareSerial * m_pSerial;
+
+    // tx buffer
+    uint16_t m_txBuf[ TX_RINGBUF_SIZE ]; // use uint16_t to store bit 9 in a convenient way
+    uint8_t  m_txHead;
+    uint8_t  m_txTail;
+    uint8_t  m_txNumChar;
+    uint8_t  m_txHighWater;
+    uint16_t m_txOverflows;
+  };
+
+  typedef JetiExTeensySerial JetiExDefaultSerial;
+
+// Host (Linux)
+///////////////
+#elif defined( JETIEX_HOST )
+
+  // default port for host builds: discards output, no keys
+  // use Start() with your own port object (i.e. capture/replay in extras/host)
+  class JetiExHostSerial final : public JetiExSerial
+  {
+  public:
+    virtual void Init() {}
+    virtual void Send( uint8_t data, boolean bit8 ) {}
+    virtual uint8_t Getchar(void) { return 0; }
+    virtual void TxOn() {}
+    virtual void TxOff() {}
   };
 
+  typedef JetiExHostSerial JetiExDefaultSerial;
+
 #else
 
   #if defined (__AVR_ATmega32U4__)
@@ -108,6 +203,10 @@ public:
     #define UDR UDR1
     #define UDRIE UDRIE1
 
+    #define RXC RXC1
+    #define TXC TXC1
+    #define UDRE UDRE1
+
     #define USART_RX_vect USART1_RX_vect
     #define USART_TX_vect USART1_TX_vect
     #define USART_UDRE_vect USART1_UDRE_vect
@@ -135,6 +234,10 @@ public:
     #define TXB8 TXB80
     #define UDR UDR0
     #define UDRIE UDRIE0
+
+    #define RXC RXC0
+    #define TXC TXC0
+    #define UDRE UDRE0
   #endif 
 
   // ATMega
@@ -153,7 +256,9 @@ public:
   extern "C" void USART_RX_vect(void) __attribute__ ((signal)); // make C++ class accessible for ISR
   extern "C" void USART_TX_vect(void) __attribute__ ((signal)); // make C++ class accessible for ISR
 
-  class JetiExHardwareSerialInt : public JetiExAtMegaSerial
+  extern JetiExRxHandler * volatile _pRxHandler;  // != 0: USART_RX_vect passes all bytes to this handler
+
+  class JetiExHardwareSerialInt final : public JetiExAtMegaSerial
   {
     friend void USART_UDRE_vect(void);
     friend void USART_RX_vect(void);
@@ -161,16 +266,50 @@ public:
 
   public:
     virtual void Init();
-    virtual void Send( uint8_t data, boolean bit8 );
     virtual uint8_t Getchar(void);
 
+    // Send one byte  
+    virtual void Send( uint8_t data, boolean bit8 )
+    {
+      JETIEX_LOCK();
+      if( m_txNumChar < TX_RINGBUF_SIZE )
+      {
+         *m_txHeadPtr = data | (bit8 ? 0x0100 : 0x0000);                       // write data to buffer
+          m_txNumChar++;                                                       // increase number of characters in buffer
+          m_txHeadPtr = IncBufPtr( m_txHeadPtr, m_txBuf, TX_RINGBUF_SIZE );    // increase ringbuf pointer
+          if( m_txNumChar > m_txHighWater )
+            m_txHighWater = m_txNumChar;
+      }
+      else
+      {
+        m_txOverflows++;                                                       // symbol is lost
+        // digitalWrite( 13, HIGH ); 
+      }
+
+      // enable transmitter
+      if( !m_bSending )
+      {
+        m_bSending    = true;
+        uint8_t ucsrb = UCSRB;
+        ucsrb        &= ~( (1<<RXEN) | (1<<RXCIE) ); // disable receiver and receiver interrupt
+        ucsrb        |=    (1<<TXEN) | (1<<UDRIE);   // enable transmitter and tx register empty interrupt 
+        UCSRB         = ucsrb;
+
+        // digitalWrite( 13, HIGH ); // show transmission
+      }
+      JETIEX_UNLOCK();
+    }
+
     virtual void TxOn() {}
     virtual void TxOff() {}
+    virtual uint16_t TxFree() { return TX_RINGBUF_SIZE - m_txNumChar; }
+    virtual uint16_t TxHighWater() { return m_txHighWater; }
+    virtual uint16_t TxOverflows() { return m_txOverflows; }
 
   protected:
     enum
     {
-      TX_RINGBUF_SIZE = 64, // 34 bytes text buffer plus 30 bytes ex buffer
+      TX_RINGBUF_SIZE = 70, // 34 bytes text frame plus 32 bytes ex frame buffer plus 4 bytes alarm: a full window fits
       RX_RINGBUF_SIZE = 4,
     };
 
@@ -179,7 +318,17 @@ public:
     volatile uint16_t * m_txHeadPtr;
     volatile uint16_t * m_txTailPtr;
     volatile uint8_t    m_txNumChar;
-    volatile uint16_t * IncBufPtr( volatile uint16_t * ptr, volatile uint16_t * ringBuf, size_t bufSize );
+    uint8_t             m_txHighWater;
+    uint16_t            m_txOverflows;
+    // increment buffer pointer (todo: use templates for 8 and 16 bit versions of pointers)
+    volatile uint16_t * IncBufPtr( volatile uint16_t * ptr, volatile uint16_t * pRingBuf, size_t bufSize )
+    {
+      ptr++;
+      if( ptr >= ( pRingBuf + bufSize ) )
+        return pRingBuf; // wrap around
+      else
+        return ptr;
+    }
 
     // rx buffer
     volatile uint8_t   m_rxBuf[ RX_RINGBUF_SIZE ]; 
@@ -191,6 +340,8 @@ public:
     // receiver state
     volatile bool       m_bSending;
   };
+
+  typedef JetiExHardwareSerialInt JetiExDefaultSerial;
   
 #endif // CORE_TEENSY
 
@@ -0,0 +1,72 @@
+/*
+  Jeti Sensor EX Telemetry C++ Library
+
+  JetiExTimer - built-in 1 ms timer for timer mode (StartTimer())
+  --------------------------------------------------------------------
+
+  Copyright (C) 2026 Bernd Wokoeck
+
+  Version history:
+  1.06   10/18/2026  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "JetiExProtocol.h"
+
+// Referenced by the inline StartTimer()/StopTimer() only: the object and the timer interrupt vector
+// are linked when your sketch uses timer mode (dot_a_linkage in library.properties).
+
+#if !defined( JETIEX_HOST ) && !defined( JETIEX_NO_TIMER )
+
+static JetiExProtocol * _pTickInstance = 0;   // instance pointer to find the protocol object from ISR
+
+#if defined( CORE_TEENSY )
+  static IntervalTimer _timer;
+  static void TimerIsr() { if( _pTickInstance ) _pTickInstance->OnTimerTick(); }
+
+  bool JetiExTimerStart( JetiExProtocol * pInstance )
+  {
+    _pTickInstance = pInstance;
+    if( _timer.begin( TimerIsr, 1000 ) )
+      return true;
+    _pTickInstance = 0;                        // all PIT channels in use
+    return false;
+  }
+  void JetiExTimerStop() { _timer.end(); _pTickInstance = 0; }
+#else
+  #include <avr/io.h>
+  #include <avr/interrupt.h>
+
+  // Timer0 runs millis() with ~1 ms overflow period, compare match B gives an additional interrupt at the same rate.
+  // analogWrite() to the OC0B pin changes the phase of the tick only
+  ISR( TIMER0_COMPB_vect ) { if( _pTickInstance ) _pTickInstance->OnTimerTick(); }
+
+  bool JetiExTimerStart( JetiExProtocol * pInstance )
+  {
+    _pTickInstance = pInstance;
+    OCR0B   = 0x80;
+    TIMSK0 |= _BV( OCIE0B );
+    return true;
+  }
+  void JetiExTimerStop() { TIMSK0 &= ~_BV( OCIE0B ); _pTickInstance = 0; }
+#endif
+
+#endif // !JETIEX_HOST && !JETIEX_NO_TIMER